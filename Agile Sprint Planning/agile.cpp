@@ -6,10 +6,109 @@
 #include <tuple>
 #include <chrono>
 #include <map>
+#include <climits>
+#include <queue>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <csignal>
+#include <cerrno>
+#endif
 ILOSTLBEGIN
 
 using namespace std;
 
+// Collects output in a fixed buffer and hands it to the stream in large blocks, formatting numbers in place, so long
+// roadmaps are written without building a string for every line
+class BufferedWriter {
+public:
+	ostream& output;
+	char buffer[1 << 16];
+	size_t used = 0;
+
+	BufferedWriter(ostream& output) : output(output) {}
+
+	BufferedWriter(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+	~BufferedWriter() {
+		flush();
+	}
+
+	void flush() {
+		output.write(buffer, used);
+		used = 0;
+	}
+
+	BufferedWriter& write(const char* text, size_t length) {
+		if (length > sizeof(buffer) - used) {
+			flush();
+
+			// Too long to be worth copying
+			if (length > sizeof(buffer)) {
+				output.write(text, length);
+				return *this;
+			}
+		}
+
+		memcpy(buffer + used, text, length);
+		used += length;
+
+		return *this;
+	}
+
+	BufferedWriter& operator << (char c) {
+		if (used == sizeof(buffer))
+			flush();
+
+		buffer[used++] = c;
+
+		return *this;
+	}
+
+	BufferedWriter& operator << (const char* text) {
+		return write(text, strlen(text));
+	}
+
+	BufferedWriter& operator << (const string& text) {
+		return write(text.data(), text.size());
+	}
+
+	BufferedWriter& operator << (long long number) {
+		if (sizeof(buffer) - used < 24)
+			flush();
+
+		used = to_chars(buffer + used, buffer + sizeof(buffer), number).ptr - buffer;
+
+		return *this;
+	}
+
+	BufferedWriter& operator << (int number) {
+		return *this << (long long)number;
+	}
+};
+
 class Story {
 public:
 	int storyNumber, businessValue, storyPoints;
@@ -129,6 +228,16 @@ public:
 			" (capacity: " + to_string(sprintCapacity) +
 			", bonus: " + to_string(sprintBonus) + ")";
 	}
+
+	// Writes what toString returns
+	void write(BufferedWriter& output) const {
+		if (sprintNumber != -1)
+			output << ">> Sprint " << sprintNumber;
+		else
+			output << ">> Product Backlog";
+
+		output << " (capacity: " << sprintCapacity << ", bonus: " << sprintBonus << ")";
+	}
 };
 
 class Point {
@@ -155,61 +264,209 @@ public:
 	}
 };
 
+// The backlog as a structure of arrays indexed by story number, with the dependency graph stored in compressed
+// sparse row (CSR) form: the dependencies of story j are dependencies[dependencyOffsets[j]] up to (but not including)
+// dependencies[dependencyOffsets[j + 1]], and likewise for its dependees
+class PlanningInstance {
+public:
+	vector<int> businessValue;
+	vector<int> storyPoints;
+	vector<int> dependencyOffsets = { 0 };
+	vector<int> dependencies;
+	vector<int> dependeeOffsets = { 0 };
+	vector<int> dependees;
+
+	vector<Sprint> sprints; // In delivery order (the product backlog isn't included)
+
+	int numberOfStories() const {
+		return businessValue.size();
+	}
+
+	// Story j as an object (for printing; the solvers work on the arrays)
+	Story story(int j) const {
+		Story story(j, businessValue[j], storyPoints[j]);
+		story.dependencies.assign(dependencies.begin() + dependencyOffsets[j], dependencies.begin() + dependencyOffsets[j + 1]);
+		story.dependees.assign(dependees.begin() + dependeeOffsets[j], dependees.begin() + dependeeOffsets[j + 1]);
+		return story;
+	}
+
+	// Writes what story(j).toString() returns, straight from the arrays
+	void writeStory(BufferedWriter& output, int j) const {
+		output << "Story " << j << " (business value: " << businessValue[j] << " | story points: " << storyPoints[j] << " | dependencies: ";
+
+		if (dependencyOffsets[j] == dependencyOffsets[j + 1])
+			output << "None";
+
+		for (int d = dependencyOffsets[j]; d < dependencyOffsets[j + 1]; ++d)
+			output << (d == dependencyOffsets[j] ? "Story " : ", Story ") << dependencies[d];
+
+		output << ")";
+	}
+
+	// Builds the dependee CSR arrays from the dependency CSR arrays with a counting sort
+	void buildDependees() {
+		int numberOfStories = this->numberOfStories();
+
+		dependeeOffsets.assign(numberOfStories + 1, 0);
+		dependees.resize(dependencies.size());
+
+		for (int dependencyNumber : dependencies)
+			++dependeeOffsets[dependencyNumber + 1];
+
+		for (int j = 0; j < numberOfStories; ++j)
+			dependeeOffsets[j + 1] += dependeeOffsets[j];
+
+		vector<int> nextDependee(dependeeOffsets.begin(), dependeeOffsets.end() - 1);
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			for (int d = dependencyOffsets[j]; d < dependencyOffsets[j + 1]; ++d)
+				dependees[nextDependee[dependencies[d]]++] = j;
+		}
+	}
+
+	// Returns the story numbers ordered so that every story comes after all of its dependencies (Kahn's algorithm)
+	// Stories on a dependency cycle are left out, as they can never be delivered
+	vector<int> topologicalOrder() const {
+		int numberOfStories = this->numberOfStories();
+		vector<int> order;
+		vector<int> unorderedDependencies(numberOfStories);
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			unorderedDependencies[j] = dependencyOffsets[j + 1] - dependencyOffsets[j];
+
+			if (unorderedDependencies[j] == 0)
+				order.push_back(j);
+		}
+
+		for (int position = 0; position < order.size(); ++position) {
+			for (int d = dependeeOffsets[order[position]]; d < dependeeOffsets[order[position] + 1]; ++d) {
+				// The dependee is ready once all of its dependencies have been ordered
+				if (--unorderedDependencies[dependees[d]] == 0)
+					order.push_back(dependees[d]);
+			}
+		}
+
+		return order;
+	}
+
+	// Returns a story on a dependency cycle, or -1 if the dependencies form a DAG (when the topological order has
+	// every story)
+	int findStoryOnCycle() const {
+		vector<int> order = topologicalOrder();
+
+		if (order.size() == numberOfStories())
+			return -1;
+
+		vector<bool> ordered(numberOfStories(), false);
+
+		for (int storyNumber : order)
+			ordered[storyNumber] = true;
+
+		return find(ordered.begin(), ordered.end(), false) - ordered.begin();
+	}
+
+	// The sprints followed by the special sprint representing the product backlog
+	vector<Sprint> toSprintData() const {
+		vector<Sprint> sprintData = sprints;
+		sprintData.push_back(Sprint(-1, 0, 0));
+		return sprintData;
+	}
+};
+
 class Roadmap {
 public:
-	vector<Story> stories;
+	// The stories are shared by every copy of the roadmap, so copying a roadmap only copies the assignments below
+	shared_ptr<const PlanningInstance> instance;
 	vector<Sprint> sprints;
 
-	map<Story, Sprint> storyToSprint;
-	map<Sprint, vector<Story>> sprintToStories;
+	// Assignments are stored in flat arrays indexed by story number and by sprint position (index into sprints),
+	// so checking and applying a move is O(1) plus the story's dependencies and dependees
+	vector<int> storySprint; // Sprint position of each story (-1 if the story is not assigned anywhere)
+	vector<int> storyPosition; // Position of each story within its sprint's list of stories
+	vector<vector<int>> sprintStories; // Story numbers assigned to each sprint
+	vector<int> sprintLoad; // Story points assigned to each sprint
+	vector<int> sprintPositions; // Sprint position of each sprint number, offset by one so the product backlog (-1) is at 0
+
+	long long totalValue = 0;
 
 	Roadmap() {};
 
-	Roadmap(vector<Story> stories, vector<Sprint> sprints) {
-		this->stories = stories;
+	Roadmap(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprints) {
+		this->instance = instance;
 		this->sprints = sprints;
+
+		int numberOfStories = instance->numberOfStories();
+
+		storySprint.assign(numberOfStories, -1);
+		storyPosition.assign(numberOfStories, -1);
+		sprintStories.resize(this->sprints.size());
+		sprintLoad.assign(this->sprints.size(), 0);
+
+		int highestSprintNumber = -1;
+
+		for (Sprint& sprint : this->sprints)
+			highestSprintNumber = max(highestSprintNumber, sprint.sprintNumber);
+
+		sprintPositions.assign(highestSprintNumber + 2, -1);
+
+		for (int i = 0; i < this->sprints.size(); ++i)
+			sprintPositions[this->sprints[i].sprintNumber + 1] = i;
+	}
+
+	int numberOfStories() const {
+		return storySprint.size();
+	}
+
+	int sprintPosition(const Sprint& sprint) {
+		return sprintPositions[sprint.sprintNumber + 1];
 	}
 
-	bool validInsert(Story story, Sprint sprint) {
+	bool isAssigned(int storyNumber) {
+		return storySprint[storyNumber] != -1;
+	}
+
+	// The sprint the story is assigned to (the story must be assigned)
+	Sprint& assignedSprint(int storyNumber) {
+		return sprints[storySprint[storyNumber]];
+	}
+
+	bool validInsert(int storyNumber, const Sprint& sprint) {
+		const PlanningInstance& stories = *instance;
+
 		// Check if adding the story overloads the sprint
-		if (story.storyPoints + storyPointsAssignedToSprint(sprint) > sprint.sprintCapacity && sprint.sprintNumber != -1)
+		if (stories.storyPoints[storyNumber] + storyPointsAssignedToSprint(sprint) > sprint.sprintCapacity && sprint.sprintNumber != -1)
 			return false;
 
 		// Check that no dependees are assigned earlier/same as the sprint
-		for (int dependeeNumber : story.dependees) {
-			Story dependee = stories[dependeeNumber];
-
-			auto it = storyToSprint.find(dependee);
+		for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d) {
+			int dependeeNumber = stories.dependees[d];
 
 			// The dependee is assigned somewhere
-			if (it != storyToSprint.end()) {
-				Sprint dependeeAssignedSprint = it->second;
+			if (storySprint[dependeeNumber] != -1) {
+				int dependeeSprintNumber = sprints[storySprint[dependeeNumber]].sprintNumber;
 
 				// The dependee is assigned earlier/same as this sprint
-				if (dependeeAssignedSprint.sprintNumber <= sprint.sprintNumber && dependeeAssignedSprint.sprintNumber != -1)
+				if (dependeeSprintNumber <= sprint.sprintNumber && dependeeSprintNumber != -1)
 					return false;
 			}
 		}
 
 		// Check that each of the story's dependencies are assigned before the sprint
-		for (int dependencyNumber : story.dependencies) {
-			Story dependency = stories[dependencyNumber];
+		for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d) {
+			int dependencyNumber = stories.dependencies[d];
 
-			auto it = storyToSprint.find(dependency);
-
-			// Only stories that are assigned to a sprint are in the map
-			if (it == storyToSprint.end())
-				// The dependee isn't assigned to a sprint
+			// The dependency isn't assigned to a sprint
+			if (storySprint[dependencyNumber] == -1)
 				return false;
 
-			Sprint dependencyAssignedSprint = it->second;
+			int dependencySprintNumber = sprints[storySprint[dependencyNumber]].sprintNumber;
 
-			// The dependee is assigned to the product backlog
-			if (dependencyAssignedSprint.sprintNumber == -1)
+			// The dependency is assigned to the product backlog
+			if (dependencySprintNumber == -1)
 				return false;
 
-			// The story is assigned to an earlier sprint than its dependee
-			if (sprint.sprintNumber <= dependencyAssignedSprint.sprintNumber)
+			// The story is assigned to an earlier sprint than its dependency
+			if (sprint.sprintNumber <= dependencySprintNumber)
 				return false;
 		}
 
@@ -217,58 +474,60 @@ public:
 		return true;
 	}
 
-	int storyPointsAssignedToSprint(Sprint sprint) {
-		vector<Story> sprintStories = sprintToStories[sprint];
+	int storyPointsAssignedToSprint(const Sprint& sprint) {
+		return sprintLoad[sprintPosition(sprint)];
+	}
 
-		// Sum of the story points of all the stories assigned to the sprint
-		int assignedStoryPoints = 0;
+	void addStoryToSprint(int storyNumber, const Sprint& sprint) {
+		if (isAssigned(storyNumber))
+			removeStoryFromSprint(storyNumber);
 
-		for (Story story : sprintStories)
-			assignedStoryPoints += story.storyPoints;
+		int position = sprintPosition(sprint);
 
-		return assignedStoryPoints;
-	}
+		storySprint[storyNumber] = position;
+		storyPosition[storyNumber] = sprintStories[position].size();
+		sprintStories[position].push_back(storyNumber);
+		sprintLoad[position] += instance->storyPoints[storyNumber];
 
-	void addStoryToSprint(Story story, Sprint sprint) {
-		storyToSprint[story] = sprint;
-		sprintToStories[sprint].push_back(story);
+		// Don't add value from stories assigned to the product backlog
+		if (sprint.sprintNumber != -1)
+			totalValue += (long long)instance->businessValue[storyNumber] * sprint.sprintBonus;
 	}
 
-	void removeStoryFromSprint(Story story, Sprint sprint) {
-		storyToSprint.erase(storyToSprint.find(story));
-		sprintToStories[sprint].erase(remove(sprintToStories[sprint].begin(), sprintToStories[sprint].end(), story), sprintToStories[sprint].end());
-	}
+	// Takes the story out of whichever sprint it is assigned to (the story must be assigned)
+	void removeStoryFromSprint(int storyNumber) {
+		int position = storySprint[storyNumber];
+		vector<int>& assignedStories = sprintStories[position];
 
-	void moveStory(Story story, Sprint from, Sprint to) {
-		removeStoryFromSprint(story, from);
-		addStoryToSprint(story, to);
-	}
+		// Swap the last story in the sprint into the removed story's place
+		int lastStoryNumber = assignedStories.back();
+		assignedStories[storyPosition[storyNumber]] = lastStoryNumber;
+		storyPosition[lastStoryNumber] = storyPosition[storyNumber];
+		assignedStories.pop_back();
 
-	int calculateValue() {
-		int totalValue = 0;
+		storySprint[storyNumber] = -1;
+		storyPosition[storyNumber] = -1;
+		sprintLoad[position] -= instance->storyPoints[storyNumber];
 
-		for (pair<Story, Sprint> pair : storyToSprint) {
-			Story story = pair.first;
-			Sprint sprint = pair.second;
+		if (sprints[position].sprintNumber != -1)
+			totalValue -= (long long)instance->businessValue[storyNumber] * sprints[position].sprintBonus;
+	}
 
-			// Don't add value from stories assigned to the product backlog
-			if (sprint.sprintNumber != -1)
-				totalValue += story.businessValue * sprint.sprintBonus;
-		}
+	void moveStory(int storyNumber, const Sprint& to) {
+		removeStoryFromSprint(storyNumber);
+		addStoryToSprint(storyNumber, to);
+	}
 
+	long long calculateValue() {
 		return totalValue;
 	}
 
 	bool sprintCapacitiesSatisifed() {
-		for (pair<Sprint, vector<Story>> pair : sprintToStories) {
-			Sprint sprint = pair.first;
-
+		for (int i = 0; i < sprints.size(); ++i) {
 			// Don't check the capacity of the product backlog
-			if (sprint.sprintNumber != -1) {
-				int assignedStoryPoints = storyPointsAssignedToSprint(sprint);
-
+			if (sprints[i].sprintNumber != -1) {
 				// Check if the sprint is overloaded
-				if (!sprint.withinCapacity(assignedStoryPoints))
+				if (!sprints[i].withinCapacity(sprintLoad[i]))
 					// The story points assigned are not within the sprint's capacity
 					return false;
 			}
@@ -279,31 +538,34 @@ public:
 	}
 
 	bool storyDependenciesSatisfied() {
-		for (pair<Story, Sprint> assignment : storyToSprint) {
-			Story story = assignment.first;
-			Sprint assignedSprint = assignment.second;
-
-			// Don't check stories assigned to the product backlog
-			if (assignedSprint.sprintNumber != -1) {
-				for (int dependeeNumber : story.dependencies) {
-					Story dependee = stories[dependeeNumber];
-					Sprint dependeeAssignedSprint = storyToSprint[dependee];
-
-					// Only stories that are assigned to a sprint are in the map
-					if (storyToSprint.find(dependee) == storyToSprint.end()) {
-						// The dependee isn't assigned to a sprint
-						return false;
-					}
-					else if (dependeeAssignedSprint.sprintNumber == -1) {
-						// The dependee is assigned to the special product backlog
+		const PlanningInstance& stories = *instance;
+
+		for (int storyNumber = 0; storyNumber < numberOfStories(); ++storyNumber) {
+			// Don't check stories that are unassigned or assigned to the product backlog
+			if (!isAssigned(storyNumber) || assignedSprint(storyNumber).sprintNumber == -1)
+				continue;
+
+			Sprint& assignedSprint = this->assignedSprint(storyNumber);
+
+			for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d) {
+				int dependeeNumber = stories.dependencies[d];
+
+				if (storySprint[dependeeNumber] == -1) {
+					// The dependee isn't assigned to a sprint
+					return false;
+				}
+
+				Sprint& dependeeAssignedSprint = sprints[storySprint[dependeeNumber]];
+
+				if (dependeeAssignedSprint.sprintNumber == -1) {
+					// The dependee is assigned to the special product backlog
+					return false;
+				}
+				else {
+					// Check where the story is assigned compared to its dependee
+					if (assignedSprint <= dependeeAssignedSprint)
+						// The story is assigned to an earlier sprint than its dependee
 						return false;
-					}
-					else {
-						// Check where the story is assigned compared to its dependee
-						if (assignedSprint <= dependeeAssignedSprint)
-							// The story is assigned to an earlier sprint than its dependee
-							return false;
-					}
 				}
 			}
 		}
@@ -319,49 +581,43 @@ public:
 	string printStoryRoadmap() {
 		string outputString = "";
 
-		for (pair<Story, Sprint> pair : storyToSprint) {
-			Story story = pair.first;
-			Sprint sprint = pair.second;
-
-			outputString += story.toString() + "\n  >> " + sprint.toString() + "\n";
+		for (int storyNumber = 0; storyNumber < numberOfStories(); ++storyNumber) {
+			if (isAssigned(storyNumber))
+				outputString += instance->story(storyNumber).toString() + "\n  >> " + assignedSprint(storyNumber).toString() + "\n";
 		}
 
 		return outputString;
 	}
 
-	string printSprintRoadmap() {
-		string outputString = "";
+	// Writes each sprint with its stories and what it delivers
+	void printSprintRoadmap(BufferedWriter& output) {
+		for (int i = 0; i < sprints.size(); ++i) {
+			Sprint& sprint = sprints[i];
 
-		for (Sprint sprint : sprints) {
 			if (sprint.sprintNumber == -1)
-				outputString += "Product Backlog";
+				output << "Product Backlog";
 			else
-				outputString += sprint.toString();
+				sprint.write(output);
 
-			vector<Story> sprintStories = sprintToStories[sprint];
-			int valueDelivered = 0;
-			int storyPointsAssigned = 0;
+			long long valueDelivered = 0;
+			long long storyPointsAssigned = 0;
 
-			if (sprintStories.empty()) {
-				outputString += "\n\tNone";
+			if (sprintStories[i].empty()) {
+				output << "\n\tNone";
 			}
 			else {
-				for (Story story : sprintStories) {
-					valueDelivered += story.businessValue;
-					storyPointsAssigned += story.storyPoints;
+				for (int storyNumber : sprintStories[i]) {
+					valueDelivered += instance->businessValue[storyNumber];
+					storyPointsAssigned += instance->storyPoints[storyNumber];
 
-					outputString += "\n\t" + story.toString();
+					output << "\n\t";
+					instance->writeStory(output, storyNumber);
 				}
 			}
 
-			outputString += "\n-- [Value: " + to_string(valueDelivered)
-				+ " (weighted value: " + to_string(valueDelivered * sprint.sprintBonus) + "), "
-				+ "story points: " + to_string(storyPointsAssigned) + "]";
-
-			outputString += "\n\n";
+			output << "\n-- [Value: " << valueDelivered << " (weighted value: " << valueDelivered * sprint.sprintBonus << "), "
+				<< "story points: " << storyPointsAssigned << "]\n\n";
 		}
-
-		return outputString;
 	}
 };
 
@@ -399,6 +655,20 @@ vector<double> geometricSequence(double a, double r, double n) {
 	return sequence;
 }
 
+// Returns the text as a JSON string, in quotes (control characters become spaces)
+string jsonString(const string& text) {
+	string quoted = "\"";
+
+	for (char c : text) {
+		if (c == '"' || c == '\\')
+			quoted += '\\';
+
+		quoted += (unsigned char)c < ' ' ? ' ' : c;
+	}
+
+	return quoted + "\"";
+}
+
 vector<string> splitString(const string& s, char delimiter) {
 	vector<string> tokens;
 	string token;
@@ -411,288 +681,7278 @@ vector<string> splitString(const string& s, char delimiter) {
 	return tokens;
 }
 
-Roadmap greedyInsertStories(vector<Story> storiesToInsert, Roadmap roadmap) {
-	while (storiesToInsert.size() > 0) {
-		Story story = storiesToInsert[0];
+// Read-only memory mapping of a whole file, so the loaders can tokenize it in place instead of copying it line by line
+class MappedFile {
+public:
+	const char* data = nullptr;
+	size_t size = 0;
+	bool opened = false;
 
-		// Greedily re-insert the story into a sprint
-		for (Sprint sprint : roadmap.sprints) {
-			if (sprint.sprintNumber == -1 || roadmap.validInsert(story, sprint)) {
-				roadmap.addStoryToSprint(story, sprint);
-				storiesToInsert.erase(remove(storiesToInsert.begin(), storiesToInsert.end(), story), storiesToInsert.end());
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+#else
+	int file = -1;
+#endif
 
-				// Break out of traversing the sprints and move to the next story
-				break;
-			}
-		}
-	}
+	MappedFile(const string& fileName) {
+#ifdef _WIN32
+		file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
 
-	return roadmap;
-}
+		if (file == INVALID_HANDLE_VALUE)
+			return;
 
-Roadmap randomRoadmap(vector<Story> storyData, vector<Sprint> sprintData) {
-	vector<Story> shuffledStories = storyData;
-	random_shuffle(shuffledStories.begin(), shuffledStories.end());
-	Roadmap roadmap = greedyInsertStories(shuffledStories, Roadmap(storyData, sprintData));
-	return roadmap;
-}
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(file, &fileSize);
+		size = (size_t)fileSize.QuadPart;
+		opened = true;
 
-int main(int argc, char* argv[]) {
-	// Seed the random number generator
-	srand(time(NULL));
+		// Empty files can't be mapped
+		if (size == 0)
+			return;
 
-	vector<Story> storyData;
-	string storyDataFileName;
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
 
-	// Holds the data about each sprint
-	vector<Sprint> sprintData;
-	string sprintDataFileName;
+		if (mapping != NULL)
+			data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		file = open(fileName.c_str(), O_RDONLY);
 
-	switch (argc) {
-	case 3:
-		storyDataFileName = argv[1];
-		sprintDataFileName = argv[2];
-		break;
-	default:
-		exit(0);
+		if (file == -1)
+			return;
+
+		struct stat fileStatus;
+		fstat(file, &fileStatus);
+		size = (size_t)fileStatus.st_size;
+		opened = true;
+
+		// Empty files can't be mapped
+		if (size == 0)
+			return;
+
+		void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (mapped != MAP_FAILED) {
+			data = (const char*)mapped;
+			madvise(mapped, size, MADV_SEQUENTIAL);
+		}
+#endif
+
+		if (data == nullptr)
+			opened = false;
 	}
 
-	// Load story data into objects //////////////////////////////////////////
-	//////////////////////////////////////////////////////////////////////////
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
 
-	string line;
-	ifstream storiesFile(storyDataFileName);
+	~MappedFile() {
+#ifdef _WIN32
+		if (data != nullptr)
+			UnmapViewOfFile(data);
 
-	getline(storiesFile, line); // Skip column headers
+		if (mapping != NULL)
+			CloseHandle(mapping);
+
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+#else
+		if (data != nullptr)
+			munmap((void*)data, size);
+
+		if (file != -1)
+			close(file);
+#endif
+	}
 
-	vector<pair<int, string>> dependenciesStrings;
+	bool isOpen() {
+		return opened;
+	}
+};
+
+// Walks the rows and comma separated fields of a CSV file in place, keeping track of the row and column for errors
+class CsvReader {
+public:
+	const char* cursor;
+	const char* end;
 
-	if (storiesFile.is_open()) {
-		while (getline(storiesFile, line)) {
-			vector<string> splitLine = splitString(line, ',');
+	const char* rowEnd = nullptr; // End of the current row (without any trailing \r)
+	const char* fieldCursor = nullptr; // Start of the next field in the row (nullptr once the row is used up)
+	int row = 0; // Line number of the current row
+	int column = 0; // Column number of the last field returned
 
-			int storyNumber = stoi(splitLine[0]);
-			int businessValue = stoi(splitLine[1]);
-			int storyPoints = stoi(splitLine[2]);
+	CsvReader(const char* data, size_t size) {
+		this->cursor = data;
+		this->end = data + size;
+	}
 
-			storyData.push_back(Story(storyNumber, businessValue, storyPoints));
+	// Moves to the next row that isn't blank, returns false at the end of the file
+	bool nextRow() {
+		while (cursor < end) {
+			const char* rowStart = cursor;
+			const char* newline = (const char*)memchr(cursor, '\n', end - cursor);
 
-			if (splitLine.size() == 4) {
-				string dependencyString = splitLine[3];
+			rowEnd = newline != nullptr ? newline : end;
+			cursor = newline != nullptr ? newline + 1 : end;
+			++row;
 
-				vector<string> splitDependencies = splitString(dependencyString, ';');
+			if (rowEnd > rowStart && rowEnd[-1] == '\r')
+				--rowEnd;
 
-				for (string dependeeString : splitDependencies) {
-					storyData[storyNumber].dependencies.push_back(stoi(dependeeString));
-				}
+			if (rowEnd > rowStart) {
+				fieldCursor = rowStart;
+				column = 0;
+				return true;
 			}
 		}
 
-		for (Story story : storyData) {
-			for (int dependency : story.dependencies) {
-				storyData[dependency].dependees.push_back(story.storyNumber);
-			}
-		}
+		return false;
 	}
-	else {
-		cout << "Cannot open story data file" << endl;
-		exit(0);
+
+	bool hasField() {
+		return fieldCursor != nullptr;
 	}
 
-	storiesFile.close();
+	// Returns the next field of the current row
+	void nextField(const char*& fieldStart, const char*& fieldEnd) {
+		const char* comma = (const char*)memchr(fieldCursor, ',', rowEnd - fieldCursor);
 
-	// Load sprint data into objects /////////////////////////////////////////
-	//////////////////////////////////////////////////////////////////////////
+		fieldStart = fieldCursor;
+		fieldEnd = comma != nullptr ? comma : rowEnd;
+		fieldCursor = comma != nullptr ? comma + 1 : nullptr;
+		++column;
+	}
 
-	ifstream sprintsFile(sprintDataFileName);
+	string location(const string& fileName) {
+		return fileName + " line " + to_string(row) + ", column " + to_string(column);
+	}
+};
 
-	getline(sprintsFile, line); // Skip column headers
+// Parses the whole of a field (ignoring surrounding spaces) as a 64-bit integer, returns false if it isn't one
+bool parseInt(const char* start, const char* end, long long& value) {
+	while (start < end && (*start == ' ' || *start == '\t'))
+		++start;
 
-	if (sprintsFile.is_open()) {
-		while (getline(sprintsFile, line)) {
-			vector<string> splitLine = splitString(line, ',');
+	while (end > start && (end[-1] == ' ' || end[-1] == '\t'))
+		--end;
 
-			int sprintNumber = stoi(splitLine[0]);
-			int sprintCapacity = stoi(splitLine[1]);
-			int sprintBonus = stoi(splitLine[2]);
+	// from_chars doesn't accept a leading plus sign
+	if (start < end && *start == '+')
+		++start;
 
-			sprintData.push_back(Sprint(sprintNumber, sprintCapacity, sprintBonus));
-		}
+	from_chars_result result = from_chars(start, end, value);
 
-		sprintData.push_back(Sprint(-1, 0, 0)); // A special sprint representing 'unassigned' (i.e. assigned to the product backlog)
-	}
-	else {
-		cout << "Cannot open sprint data file" << endl;
-		exit(0);
-	}
+	return start < end && result.ec == errc() && result.ptr == end;
+}
 
-	sprintsFile.close();
+// Parses the whole of a field (ignoring surrounding spaces) as an int, returns false if it isn't one
+bool parseInt(const char* start, const char* end, int& value) {
+	long long wideValue;
 
-	auto t_solveStart = chrono::high_resolution_clock::now();
+	if (!parseInt(start, end, wideValue) || wideValue < INT_MIN || wideValue > INT_MAX)
+		return false;
 
-	int numberOfStories = storyData.size();
-	int numberOfSprints = sprintData.size();
+	value = (int)wideValue;
 
-	IloEnv env;
+	return true;
+}
 
-	try {
-		IloModel model(env);
+// Reads a whole string as a finite number, returns false if any of it isn't part of one (atof would read "10s" as
+// 10 and "abc" as 0)
+bool parseDouble(const string& text, double& value) {
+	char* end;
+	value = strtod(text.c_str(), &end);
 
-		// 2D array of Boolean decision variables (roadmap[i][j] == 1 means user story j is taken in sprint i)
-		IloArray<IloBoolVarArray> roadmap(env, numberOfSprints);
+	return !text.empty() && *end == '\0' && isfinite(value);
+}
 
-		// Total business value delivered (across the whole roadmap)
-		IloNumExpr deliveredValue(env, 0);
+// Reads a whole string as an integer, returns false if any of it isn't part of one
+bool parseInt(const string& text, int& value) {
+	return parseInt(text.data(), text.data() + text.size(), value);
+}
 
-		for (int i = 0; i < numberOfSprints; ++i) {
-			// Sum of the story points taken in the sprint i
-			IloNumExpr storyPointsTaken(env, 0);
+bool parseInt(const string& text, long long& value) {
+	return parseInt(text.data(), text.data() + text.size(), value);
+}
 
-			// Sprint i is represented by an array of Boolean decision variables
-			roadmap[i] = IloBoolVarArray(env, numberOfStories);
+// Loads the story data file (story, business value, story points, optional ';' separated dependencies) into the
+// instance in one pass over the memory-mapped file, returns false with a description of the first problem found
+// Stories must be numbered from 0 with no gaps, but the rows can be in any order
+bool loadStoryData(const string& fileName, PlanningInstance& instance, string& error) {
+	MappedFile file(fileName);
 
-			for (int j = 0; j < numberOfStories; ++j) {
-				// Create a Boolean decision variable
-				roadmap[i][j] = IloBoolVar(env);
+	if (!file.isOpen()) {
+		error = "Cannot open story data file";
+		return false;
+	}
 
-				// Add business value (including sprint bonus), if story is taken in this sprint
-				deliveredValue += storyData[j].businessValue * sprintData[i].sprintBonus * roadmap[i][j];
+	CsvReader reader(file.data, file.size);
+	reader.nextRow(); // Skip column headers
+
+	// Filled in file order first, and only reordered if the rows aren't already in story number order
+	vector<int> rowStoryNumbers;
+	vector<int>& businessValue = instance.businessValue;
+	vector<int>& storyPoints = instance.storyPoints;
+	vector<int>& dependencyOffsets = instance.dependencyOffsets;
+	vector<int>& dependencies = instance.dependencies;
+
+	businessValue.clear();
+	storyPoints.clear();
+	dependencyOffsets.assign(1, 0);
+	dependencies.clear();
+
+	// Rough guess at the number of rows, to avoid most reallocations
+	size_t expectedRows = file.size / 16 + 1;
+	rowStoryNumbers.reserve(expectedRows);
+	businessValue.reserve(expectedRows);
+	storyPoints.reserve(expectedRows);
+	dependencyOffsets.reserve(expectedRows + 1);
+
+	vector<int> firstRowOfStory; // Row of each story number seen so far (0 if not seen), for duplicate checks
+	bool inOrder = true;
+
+	// Every story number must be below the number of rows, so a bad one is caught before it sizes firstRowOfStory
+	size_t rowsInFile = count(file.data, file.data + file.size, '\n') + 1;
+
+	while (reader.nextRow()) {
+		const char* fieldStart;
+		const char* fieldEnd;
+		int fields[3];
+		const char* fieldNames[3] = { "story number", "business value", "story points" };
+
+		for (int f = 0; f < 3; ++f) {
+			if (!reader.hasField()) {
+				error = reader.location(fileName) + ": missing " + fieldNames[f];
+				return false;
+			}
 
-				// Add story points, if story j is taken in sprint i
-				storyPointsTaken += storyData[j].storyPoints * roadmap[i][j];
+			reader.nextField(fieldStart, fieldEnd);
+
+			if (!parseInt(fieldStart, fieldEnd, fields[f])) {
+				error = reader.location(fileName) + ": " + fieldNames[f] + " '" + string(fieldStart, fieldEnd) + "' is not a whole number";
+				return false;
 			}
 
-			// If the sprint has stories assigned, make sure that the sprint is not overloaded
-			model.add(IloIfThen(env, storyPointsTaken > 0, storyPointsTaken <= sprintData[i].sprintCapacity));
+			if (fields[f] < 0) {
+				error = reader.location(fileName) + ": " + fieldNames[f] + " can't be negative";
+				return false;
+			}
 		}
 
-		// Story is only assiged to one (or no) sprint
-		for (int j = 0; j < numberOfStories; ++j) {
-			// How many times story j is assigned in sprint i
-			IloNumExpr numberOfTimesStoryIsUsed(env, 0);
+		int storyNumber = fields[0];
 
-			for (int i = 0; i < numberOfSprints; ++i) {
-				numberOfTimesStoryIsUsed += roadmap[i][j];
-			}
+		if (storyNumber >= rowsInFile) {
+			reader.column = 1;
+			error = reader.location(fileName) + ": story number " + to_string(storyNumber) + " is out of range (the file has only "
+				+ to_string(rowsInFile) + " lines)";
+			return false;
+		}
 
-			// Story j can be included in sprint i <= 1 times
-			model.add(numberOfTimesStoryIsUsed <= 1);
+		if (storyNumber >= firstRowOfStory.size())
+			firstRowOfStory.resize(min(max((size_t)storyNumber + 1, firstRowOfStory.size() * 2), rowsInFile), 0);
+
+		if (firstRowOfStory[storyNumber] != 0) {
+			reader.column = 1;
+			error = reader.location(fileName) + ": story " + to_string(storyNumber) + " was already given on line " + to_string(firstRowOfStory[storyNumber]);
+			return false;
 		}
 
-		// Add dependency constraints
-		for (int i = 0; i < numberOfSprints; ++i) {
-			for (int j = 0; j < numberOfStories; ++j) {
-				// How many dependencies the story has
-				int numberOfDependencies = storyData[j].dependencies.size();
+		firstRowOfStory[storyNumber] = reader.row;
+		inOrder = inOrder && storyNumber == rowStoryNumbers.size();
 
-				// No dependency-checking constraints are added for stories with no dependencies
-				for (int d = 0; d < numberOfDependencies; ++d) {
-					// The story number of the dependee story
-					int storyToCheck = storyData[j].dependencies[d];
+		rowStoryNumbers.push_back(storyNumber);
+		businessValue.push_back(fields[1]);
+		storyPoints.push_back(fields[2]);
 
-					// How many times the dependee stories havr been assigned before this sprint
-					IloNumExpr numberOfTimesDependeesPreAssigned(env, 0);
+		if (reader.hasField()) {
+			reader.nextField(fieldStart, fieldEnd);
 
-					// Count how many times the dependee has been included between the first sprint and the current sprint
-					for (int sprintLookback = 0; sprintLookback < i; ++sprintLookback) {
-						numberOfTimesDependeesPreAssigned += roadmap[sprintLookback][storyToCheck];
-					}
+			// Dependencies are separated by semicolons, and an empty field means there are none
+			while (fieldStart < fieldEnd) {
+				const char* separator = (const char*)memchr(fieldStart, ';', fieldEnd - fieldStart);
+				const char* dependencyEnd = separator != nullptr ? separator : fieldEnd;
+				int dependencyNumber;
 
-					// roadmap[i][j] == 1 means that dependent story j is taken in sprint i, so dependee story d must appear in previous roadmap
-					// roadmap[i][j] == 0 means that dependent story j is not taken in sprint i, so dependee story d may or may not appear in previous roadmap
-					model.add(IloIfThen(env, roadmap[i][j] == 1, numberOfTimesDependeesPreAssigned == 1));
+				if (!parseInt(fieldStart, dependencyEnd, dependencyNumber) || dependencyNumber < 0) {
+					error = reader.location(fileName) + ": dependency '" + string(fieldStart, dependencyEnd) + "' is not a story number";
+					return false;
+				}
 
-					// NOTE - is numberOfTimesDependeesPreAssigned == 1 (per dependee, per story) better than numberOfTimesDependeesPreAssigned == numberOfDependencies (per story)?
-					// i.e. is it better to have more or fewer constraints that check the same thing?
-					// It seems to run faster to have a constraint per dependee, per story
+				if (dependencyNumber == storyNumber) {
+					error = reader.location(fileName) + ": story " + to_string(storyNumber) + " depends on itself";
+					return false;
 				}
+
+				dependencies.push_back(dependencyNumber);
+				fieldStart = separator != nullptr ? separator + 1 : fieldEnd;
 			}
 		}
 
-		// Objective function
-		model.add(IloMaximize(env, deliveredValue));
+		if (reader.hasField()) {
+			reader.nextField(fieldStart, fieldEnd);
+			error = reader.location(fileName) + ": unexpected extra column";
+			return false;
+		}
 
-		IloCplex cplex(model);
-		cplex.setOut(env.getNullStream());
+		dependencyOffsets.push_back(dependencies.size());
+	}
 
-		// CPLEX tuning
-		// http://www-01.ibm.com/support/docview.wss?uid=swg21400023#Item6
+	int numberOfStories = rowStoryNumbers.size();
 
-		// Use MIP start to help the B&B by giving it a greedily-built solution
-		// https://www.ibm.com/support/knowledgecenter/SSSA5P_12.8.0/ilog.odms.cplex.help/CPLEX/OverviewAPIs/topics/MIP_starts.html
+	// Every story number from 0 to the number of stories must be used, and dependencies must refer to them
+	for (int row = 0; row < numberOfStories; ++row) {
+		if (rowStoryNumbers[row] >= numberOfStories) {
+			error = fileName + " line " + to_string(firstRowOfStory[rowStoryNumbers[row]]) + ", column 1: story number "
+				+ to_string(rowStoryNumbers[row]) + " is out of range (stories must be numbered 0 to " + to_string(numberOfStories - 1) + ")";
+			return false;
+		}
 
-		//////////////////////////////////////////////////////////////////////////
+		for (int d = dependencyOffsets[row]; d < dependencyOffsets[row + 1]; ++d) {
+			if (dependencies[d] >= numberOfStories) {
+				error = fileName + " line " + to_string(firstRowOfStory[rowStoryNumbers[row]]) + ", column 4: dependency "
+					+ to_string(dependencies[d]) + " is not a story";
+				return false;
+			}
+		}
+	}
 
-		Roadmap warmStart = randomRoadmap(storyData, sprintData);
+	if (!inOrder) {
+		// Put the rows into story number order
+		vector<int> rowOfStory(numberOfStories);
 
-		IloNumVarArray startVar(env);
-		IloNumArray startVal(env);
+		for (int row = 0; row < numberOfStories; ++row)
+			rowOfStory[rowStoryNumbers[row]] = row;
 
-		for (auto pair : warmStart.sprintToStories) {
-			Sprint sprint = pair.first;
+		vector<int> orderedValue(numberOfStories), orderedPoints(numberOfStories), orderedOffsets(1, 0), orderedDependencies;
+		orderedOffsets.reserve(numberOfStories + 1);
+		orderedDependencies.reserve(dependencies.size());
 
-			if (sprint.sprintNumber != -1) {
-				vector<Story> stories = pair.second;
+		for (int j = 0; j < numberOfStories; ++j) {
+			int row = rowOfStory[j];
 
-				for (Story story : stories) {
-					startVar.add(roadmap[sprint.sprintNumber][story.storyNumber]);
-					startVal.add(1);
-				}
-			}
+			orderedValue[j] = businessValue[row];
+			orderedPoints[j] = storyPoints[row];
+			orderedDependencies.insert(orderedDependencies.end(), dependencies.begin() + dependencyOffsets[row], dependencies.begin() + dependencyOffsets[row + 1]);
+			orderedOffsets.push_back(orderedDependencies.size());
 		}
 
-		cplex.addMIPStart(startVar, startVal);
+		businessValue.swap(orderedValue);
+		storyPoints.swap(orderedPoints);
+		dependencyOffsets.swap(orderedOffsets);
+		dependencies.swap(orderedDependencies);
+	}
 
-		startVal.end();
-		startVar.end();
-		
-		//////////////////////////////////////////////////////////////////////////
+	instance.buildDependees();
 
-		if (cplex.solve()) {
-			auto t_solveEnd = chrono::high_resolution_clock::now();
+	int storyOnCycle = instance.findStoryOnCycle();
 
-			int totalStoriesDelivered = 0;
-			int totalBusinessValueDelivered = 0;
-			int totalStoryPointsDelivered = 0;
+	if (storyOnCycle != -1) {
+		error = fileName + " line " + to_string(firstRowOfStory[storyOnCycle]) + ": story " + to_string(storyOnCycle) + " is part of a dependency cycle";
+		return false;
+	}
 
-			// Output the solution
-			for (int i = 0; i < numberOfSprints; ++i) {
-				// Sprint information
-				cout << sprintData[i].toString() << endl;
+	return true;
+}
 
-				int businessValueDelivered = 0;
-				int storyPointedDelivered = 0;
+// Loads the sprint data file (sprint, capacity, bonus) into the instance, returns false with a description of the
+// first problem found. Sprints must be numbered 0, 1, 2, ... in delivery order
+bool loadSprintData(const string& fileName, PlanningInstance& instance, string& error) {
+	MappedFile file(fileName);
 
-				for (int j = 0; j < numberOfStories; ++j) {
-					// If the story was taken in this sprint, print the story's information
-					if (cplex.getValue(roadmap[i][j]) == 1) {
-						businessValueDelivered += storyData[j].businessValue;
-						storyPointedDelivered += storyData[j].storyPoints;
+	if (!file.isOpen()) {
+		error = "Cannot open sprint data file";
+		return false;
+	}
 
-						// Running totals for how much the roadmap delivered overall
-						totalBusinessValueDelivered += storyData[j].businessValue;
-						totalStoryPointsDelivered += storyData[j].storyPoints;
+	CsvReader reader(file.data, file.size);
+	reader.nextRow(); // Skip column headers
 
-						cout << "\t" << storyData[j].toString() << endl;
-					}
-				}
+	instance.sprints.clear();
 
-				// What was delivered in the sprint
-				cout << "-- [Value: " << to_string(businessValueDelivered)
-					<< " (weighted business value: " << to_string(businessValueDelivered * sprintData[i].sprintBonus) << "), "
-					<< "story points: " << to_string(storyPointedDelivered) << "]" << endl << endl;
+	while (reader.nextRow()) {
+		const char* fieldStart;
+		const char* fieldEnd;
+		int fields[3];
+		const char* fieldNames[3] = { "sprint number", "capacity", "bonus" };
+
+		for (int f = 0; f < 3; ++f) {
+			if (!reader.hasField()) {
+				error = reader.location(fileName) + ": missing " + fieldNames[f];
+				return false;
 			}
 
-			cout << endl << cplex.getStatus() << endl;
-			cout << "Solved in " << chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count() << " ms" << endl << endl;
-			cout << "Stories: " << storyData.size() << ", sprints: " << sprintData.size() << endl;
-			cout << "Total weighted business value: " << cplex.getObjValue() << endl << endl;
-			cout << "----------------------------------------" << endl;
+			reader.nextField(fieldStart, fieldEnd);
 
-			//cout << endl << storyData.size() << "," << sprintData.size() - 1 << "," << set << ",cold";
-			//cout << "," << cplex.getObjValue() << "," << chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count();
+			if (!parseInt(fieldStart, fieldEnd, fields[f])) {
+				error = reader.location(fileName) + ": " + fieldNames[f] + " '" + string(fieldStart, fieldEnd) + "' is not a whole number";
+				return false;
+			}
+
+			if (fields[f] < 0) {
+				error = reader.location(fileName) + ": " + fieldNames[f] + " can't be negative";
+				return false;
+			}
+		}
+
+		if (reader.hasField()) {
+			reader.nextField(fieldStart, fieldEnd);
+			error = reader.location(fileName) + ": unexpected extra column";
+			return false;
+		}
+
+		if (fields[0] != instance.sprints.size()) {
+			reader.column = 1;
+			error = reader.location(fileName) + ": expected sprint " + to_string(instance.sprints.size()) + " but found sprint " + to_string(fields[0]);
+			return false;
+		}
+
+		instance.sprints.push_back(Sprint(fields[0], fields[1], fields[2]));
+	}
+
+	return true;
+}
+
+// The original line-by-line loader, kept as the baseline for --benchmark=loader
+vector<Story> loadStoryDataLineByLine(string storyDataFileName) {
+	vector<Story> storyData;
+
+	string line;
+	ifstream storiesFile(storyDataFileName);
+
+	getline(storiesFile, line); // Skip column headers
+
+	while (getline(storiesFile, line)) {
+		vector<string> splitLine = splitString(line, ',');
+
+		int storyNumber = stoi(splitLine[0]);
+		int businessValue = stoi(splitLine[1]);
+		int storyPoints = stoi(splitLine[2]);
+
+		storyData.push_back(Story(storyNumber, businessValue, storyPoints));
+
+		if (splitLine.size() == 4) {
+			string dependencyString = splitLine[3];
+
+			vector<string> splitDependencies = splitString(dependencyString, ';');
+
+			for (string dependeeString : splitDependencies) {
+				storyData[storyNumber].dependencies.push_back(stoi(dependeeString));
+			}
+		}
+	}
+
+	for (Story story : storyData) {
+		for (int dependency : story.dependencies) {
+			storyData[dependency].dependees.push_back(story.storyNumber);
+		}
+	}
+
+	return storyData;
+}
+
+// Binary instance cache /////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+// Layout of a cache file: this header, then the int32 arrays businessValue[n], storyPoints[n],
+// dependencyOffsets[n + 1], dependencies[d], dependeeOffsets[n + 1], dependees[d] and the sprint table (number,
+// capacity, bonus)[m], in native byte order
+struct InstanceCacheHeader {
+	char magic[8]; // "AGILEINS"
+	uint32_t version;
+	uint32_t headerSize;
+	uint64_t contentHash; // Of the story and sprint data files the instance was loaded from
+	int32_t numberOfStories;
+	int32_t numberOfDependencies;
+	int32_t numberOfSprints;
+	int32_t reserved;
+};
+
+const uint32_t INSTANCE_CACHE_VERSION = 1;
+
+// 64-bit FNV-1a hash of the file contents, continuing from hash (so several files can be hashed together)
+uint64_t hashFileContents(const MappedFile& file, uint64_t hash = 14695981039346656037ULL) {
+	for (size_t i = 0; i < file.size; ++i) {
+		hash ^= (unsigned char)file.data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+// Returns the name of the cache file for the story and sprint data files, or "" if either can't be opened
+string instanceCacheFileName(const string& cacheDirectory, const string& storyDataFileName, const string& sprintDataFileName, uint64_t& contentHash) {
+	MappedFile storiesFile(storyDataFileName);
+	MappedFile sprintsFile(sprintDataFileName);
+
+	if (!storiesFile.isOpen() || !sprintsFile.isOpen())
+		return "";
+
+	// Hash the file sizes in too, so moving bytes between the two files changes the key
+	contentHash = hashFileContents(storiesFile) ^ storiesFile.size;
+	contentHash = hashFileContents(sprintsFile, contentHash * 1099511628211ULL) ^ sprintsFile.size;
+
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)contentHash);
+
+	return cacheDirectory + "/" + hex + ".agileinstance";
+}
+
+// Writes the instance to a cache file (via a temporary file, so a partly written cache is never read)
+bool writeInstanceCache(const string& cacheFileName, uint64_t contentHash, PlanningInstance& instance) {
+	InstanceCacheHeader header = {};
+	memcpy(header.magic, "AGILEINS", 8);
+	header.version = INSTANCE_CACHE_VERSION;
+	header.headerSize = sizeof(InstanceCacheHeader);
+	header.contentHash = contentHash;
+	header.numberOfStories = instance.numberOfStories();
+	header.numberOfDependencies = instance.dependencies.size();
+	header.numberOfSprints = instance.sprints.size();
+
+	vector<int32_t> sprintTable;
+
+	for (Sprint& sprint : instance.sprints) {
+		sprintTable.push_back(sprint.sprintNumber);
+		sprintTable.push_back(sprint.sprintCapacity);
+		sprintTable.push_back(sprint.sprintBonus);
+	}
+
+	string temporaryFileName = cacheFileName + ".tmp";
+	ofstream cacheFile(temporaryFileName, ios::binary | ios::trunc);
+
+	if (!cacheFile.is_open())
+		return false;
+
+	auto writeArray = [&](const vector<int>& values) {
+		cacheFile.write((const char*)values.data(), values.size() * sizeof(int32_t));
+	};
+
+	cacheFile.write((const char*)&header, sizeof(header));
+	writeArray(instance.businessValue);
+	writeArray(instance.storyPoints);
+	writeArray(instance.dependencyOffsets);
+	writeArray(instance.dependencies);
+	writeArray(instance.dependeeOffsets);
+	writeArray(instance.dependees);
+	writeArray(sprintTable);
+	cacheFile.close();
+
+	if (cacheFile.fail()) {
+		remove(temporaryFileName.c_str());
+		return false;
+	}
+
+	remove(cacheFileName.c_str()); // Windows won't rename over an existing file
+	return rename(temporaryFileName.c_str(), cacheFileName.c_str()) == 0;
+}
+
+// Reads the instance from a memory-mapped cache file, returns false if it is missing, stale or damaged (the arrays
+// are checked to be what loadStoryData and loadSprintData would accept, so a damaged cache is rebuilt rather than
+// read out of bounds)
+bool readInstanceCache(const string& cacheFileName, uint64_t contentHash, PlanningInstance& instance) {
+	MappedFile cacheFile(cacheFileName);
+
+	if (!cacheFile.isOpen() || cacheFile.size < sizeof(InstanceCacheHeader))
+		return false;
+
+	InstanceCacheHeader header;
+	memcpy(&header, cacheFile.data, sizeof(header));
+
+	if (memcmp(header.magic, "AGILEINS", 8) != 0 || header.version != INSTANCE_CACHE_VERSION || header.headerSize != sizeof(InstanceCacheHeader)
+		|| header.contentHash != contentHash || header.numberOfStories < 0 || header.numberOfDependencies < 0 || header.numberOfSprints < 0)
+		return false;
+
+	size_t n = header.numberOfStories;
+	size_t d = header.numberOfDependencies;
+	size_t m = header.numberOfSprints;
+
+	if (cacheFile.size != sizeof(InstanceCacheHeader) + (4 * n + 2 + 2 * d + 3 * m) * sizeof(int32_t))
+		return false;
+
+	const char* cursor = cacheFile.data + sizeof(InstanceCacheHeader);
+
+	auto readArray = [&](vector<int>& values, size_t size) {
+		values.resize(size);
+		memcpy(values.data(), cursor, size * sizeof(int32_t));
+		cursor += size * sizeof(int32_t);
+	};
+
+	vector<int> sprintTable;
+
+	readArray(instance.businessValue, n);
+	readArray(instance.storyPoints, n);
+	readArray(instance.dependencyOffsets, n + 1);
+	readArray(instance.dependencies, d);
+	readArray(instance.dependeeOffsets, n + 1);
+	readArray(instance.dependees, d);
+	readArray(sprintTable, 3 * m);
+
+	auto validOffsets = [&](const vector<int>& offsets) {
+		if (offsets[0] != 0 || offsets[n] != d)
+			return false;
+
+		for (size_t j = 0; j < n; ++j) {
+			if (offsets[j] > offsets[j + 1])
+				return false;
+		}
+
+		return true;
+	};
+
+	auto validStoryNumbers = [&](const vector<int>& storyNumbers) {
+		for (int storyNumber : storyNumbers) {
+			if (storyNumber < 0 || storyNumber >= n)
+				return false;
+		}
+
+		return true;
+	};
+
+	// The file was written by writeInstanceCache from a validated instance and is keyed by the content hash, so only
+	// the cheap checks that keep a truncated or damaged file from indexing out of bounds are made here (rebuilding
+	// the dependees or checking for cycles again would cost as much as the parse the cache exists to skip)
+	if (!validOffsets(instance.dependencyOffsets) || !validOffsets(instance.dependeeOffsets)
+		|| !validStoryNumbers(instance.dependencies) || !validStoryNumbers(instance.dependees))
+		return false;
+
+	for (size_t j = 0; j < n; ++j) {
+		if (instance.businessValue[j] < 0 || instance.storyPoints[j] < 0)
+			return false;
+	}
+
+	instance.sprints.clear();
+
+	for (size_t k = 0; k < m; ++k) {
+		if (sprintTable[3 * k] != k || sprintTable[3 * k + 1] < 0 || sprintTable[3 * k + 2] < 0)
+			return false;
+
+		instance.sprints.push_back(Sprint(sprintTable[3 * k], sprintTable[3 * k + 1], sprintTable[3 * k + 2]));
+	}
+
+	return true;
+}
+
+// Loads the instance from the cache when there is an up to date one in the cache directory, otherwise parses the
+// data files and writes the cache for next time (no caching if cacheDirectory is "")
+bool loadPlanningInstance(const string& storyDataFileName, const string& sprintDataFileName, const string& cacheDirectory,
+	PlanningInstance& instance, string& error, bool& loadedFromCache) {
+	loadedFromCache = false;
+
+	uint64_t contentHash = 0;
+	string cacheFileName;
+
+	if (cacheDirectory != "") {
+		cacheFileName = instanceCacheFileName(cacheDirectory, storyDataFileName, sprintDataFileName, contentHash);
+
+		if (cacheFileName != "" && readInstanceCache(cacheFileName, contentHash, instance)) {
+			loadedFromCache = true;
+			return true;
+		}
+	}
+
+	if (!loadStoryData(storyDataFileName, instance, error) || !loadSprintData(sprintDataFileName, instance, error))
+		return false;
+
+	if (cacheFileName != "" && !writeInstanceCache(cacheFileName, contentHash, instance))
+		cerr << "Warning: cannot write instance cache " << cacheFileName << endl;
+
+	return true;
+}
+
+// Times the line-by-line loader, the memory-mapped loader and the binary instance cache on the data files
+void benchmarkLoaders(string storyDataFileName, string sprintDataFileName, string cacheDirectory, int repetitions) {
+	double lineByLineMilliseconds = 0;
+	double mappedMilliseconds = 0;
+	double cachedMilliseconds = 0;
+	int numberOfStories = 0;
+
+	// Make sure the cache exists before timing reads from it
+	PlanningInstance cachedInstance;
+	string error;
+	bool loadedFromCache;
+
+	if (cacheDirectory != "" && !loadPlanningInstance(storyDataFileName, sprintDataFileName, cacheDirectory, cachedInstance, error, loadedFromCache)) {
+		cout << error << endl;
+		return;
+	}
+
+	for (int repetition = 0; repetition < repetitions; ++repetition) {
+		auto t_start = chrono::high_resolution_clock::now();
+		vector<Story> storyData = loadStoryDataLineByLine(storyDataFileName);
+		auto t_lineByLineEnd = chrono::high_resolution_clock::now();
+
+		PlanningInstance instance;
+
+		if (!loadStoryData(storyDataFileName, instance, error) || !loadSprintData(sprintDataFileName, instance, error)) {
+			cout << error << endl;
+			return;
+		}
+
+		auto t_mappedEnd = chrono::high_resolution_clock::now();
+
+		if (cacheDirectory != "")
+			loadPlanningInstance(storyDataFileName, sprintDataFileName, cacheDirectory, cachedInstance, error, loadedFromCache);
+
+		auto t_cachedEnd = chrono::high_resolution_clock::now();
+
+		lineByLineMilliseconds += chrono::duration<double, std::milli>(t_lineByLineEnd - t_start).count();
+		mappedMilliseconds += chrono::duration<double, std::milli>(t_mappedEnd - t_lineByLineEnd).count();
+		cachedMilliseconds += chrono::duration<double, std::milli>(t_cachedEnd - t_mappedEnd).count();
+		numberOfStories = instance.numberOfStories();
+	}
+
+	lineByLineMilliseconds /= repetitions;
+	mappedMilliseconds /= repetitions;
+	cachedMilliseconds /= repetitions;
+
+	cout << "Stories: " << numberOfStories << " (average of " << repetitions << " loads)" << endl;
+	cout << "Line by line (stories only): " << lineByLineMilliseconds << " ms (" << (long long)(numberOfStories / lineByLineMilliseconds * 1000) << " rows per second)" << endl;
+	cout << "Memory-mapped: " << mappedMilliseconds << " ms (" << (long long)(numberOfStories / mappedMilliseconds * 1000) << " rows per second)" << endl;
+
+	if (cacheDirectory != "")
+		cout << "Instance cache (including content hash): " << cachedMilliseconds << " ms (" << (long long)(numberOfStories / cachedMilliseconds * 1000) << " rows per second)" << endl;
+}
+
+// Seeded generator of synthetic backlogs for benchmarking
+// Story points and business values are drawn from geometric distributions over their scales, sprint capacities
+// add up to a chosen fraction of all the story points, and dependencies only point from a story to stories in
+// earlier layers, which makes the dependency graph a DAG with at most the chosen depth
+class InstanceGenerator {
+public:
+	double capacityTightness = 0.5; // Total sprint capacity as a fraction of the total story points
+	double pointsSkew = 0.7; // Ratio between the chances of consecutive story point sizes (below 1 favours small stories)
+	double valueSkew = 0.85; // Ratio between the chances of consecutive business values (below 1 favours low values)
+	double dependencyDensity = 0.5; // Average number of dependencies per story
+	int dependencyDepth = 5; // Number of layers in the dependency graph (its longest chain has this many stories)
+
+	const vector<int> pointSizes = { 1, 2, 3, 5, 8, 13, 21 };
+	const int highestBusinessValue = 20;
+
+	// Returns a random position in the weights (which don't have to add up to 1)
+	// Uses the raw generator output rather than std::discrete_distribution, so instances are the same on every platform
+	int randomWeightedPosition(mt19937& generator, const vector<double>& weights) {
+		double total = 0;
+
+		for (double weight : weights)
+			total += weight;
+
+		double threshold = generator() / 4294967296.0 * total;
+
+		for (int i = 0; i < weights.size(); ++i) {
+			threshold -= weights[i];
+
+			if (threshold < 0)
+				return i;
+		}
+
+		return weights.size() - 1;
+	}
+
+	PlanningInstance generate(int numberOfStories, int numberOfSprints, unsigned int seed) {
+		mt19937 generator(seed);
+		PlanningInstance instance;
+
+		vector<double> pointWeights = geometricSequence(1, pointsSkew, pointSizes.size());
+		vector<double> valueWeights = geometricSequence(1, valueSkew, highestBusinessValue);
+
+		long long totalStoryPoints = 0;
+
+		// Stories are split into consecutive layers, so layer l starts at story layerStart[l]
+		int layers = max(1, min(dependencyDepth, numberOfStories));
+		vector<int> layerStart;
+
+		for (int layer = 0; layer <= layers; ++layer)
+			layerStart.push_back((long long)numberOfStories * layer / layers);
+
+		for (int layer = 0; layer < layers; ++layer) {
+			for (int j = layerStart[layer]; j < layerStart[layer + 1]; ++j) {
+				instance.storyPoints.push_back(pointSizes[randomWeightedPosition(generator, pointWeights)]);
+				instance.businessValue.push_back(1 + randomWeightedPosition(generator, valueWeights));
+				totalStoryPoints += instance.storyPoints.back();
+
+				if (layer > 0) {
+					// The whole part of the density is always used, and the fractional part is a chance of one more
+					int numberOfDependencies = (int)dependencyDensity;
+
+					if (generator() / 4294967296.0 < dependencyDensity - numberOfDependencies)
+						++numberOfDependencies;
+
+					int firstDependency = instance.dependencies.size();
+
+					for (int d = 0; d < numberOfDependencies; ++d) {
+						// Half of the dependencies are on the layer just above, which keeps the chains deep
+						int from = generator() % 2 == 0 ? layerStart[layer - 1] : 0;
+						int dependencyNumber = from + generator() % (layerStart[layer] - from);
+
+						if (find(instance.dependencies.begin() + firstDependency, instance.dependencies.end(), dependencyNumber) == instance.dependencies.end())
+							instance.dependencies.push_back(dependencyNumber);
+					}
+				}
+
+				instance.dependencyOffsets.push_back(instance.dependencies.size());
+			}
+		}
+
+		instance.buildDependees();
+
+		// Capacities vary by up to a quarter either side of the average, and earlier sprints have higher bonuses
+		long long averageCapacity = max(1LL, (long long)(totalStoryPoints * capacityTightness / max(1, numberOfSprints)));
+
+		for (int i = 0; i < numberOfSprints; ++i) {
+			int capacity = averageCapacity * 3 / 4 + generator() % (averageCapacity / 2 + 1);
+			instance.sprints.push_back(Sprint(i, capacity, numberOfSprints - i));
+		}
+
+		return instance;
+	}
+};
+
+// Writes the instance in the format loadStoryData and loadSprintData read
+bool writeInstanceFiles(PlanningInstance& instance, const string& storyDataFileName, const string& sprintDataFileName) {
+	ofstream storiesFile(storyDataFileName, ios::trunc);
+	ofstream sprintsFile(sprintDataFileName, ios::trunc);
+
+	if (!storiesFile.is_open() || !sprintsFile.is_open())
+		return false;
+
+	string line;
+
+	storiesFile << "Story,Business Value,Story Points,Dependencies\n";
+
+	for (int j = 0; j < instance.numberOfStories(); ++j) {
+		line = to_string(j) + "," + to_string(instance.businessValue[j]) + "," + to_string(instance.storyPoints[j]);
+
+		for (int d = instance.dependencyOffsets[j]; d < instance.dependencyOffsets[j + 1]; ++d)
+			line += (d == instance.dependencyOffsets[j] ? "," : ";") + to_string(instance.dependencies[d]);
+
+		storiesFile << line << "\n";
+	}
+
+	sprintsFile << "Sprint,Capacity,Bonus\n";
+
+	for (Sprint& sprint : instance.sprints)
+		sprintsFile << sprint.sprintNumber << "," << sprint.sprintCapacity << "," << sprint.sprintBonus << "\n";
+
+	storiesFile.close();
+	sprintsFile.close();
+
+	return !storiesFile.fail() && !sprintsFile.fail();
+}
+
+// Clears the peak resident memory of the process where the platform allows it (only Linux), so the next reading
+// starts from what is resident now rather than from the highest point of everything the process has run before
+void resetPeakResidentMemory() {
+#ifdef __linux__
+	ofstream clearRefs("/proc/self/clear_refs");
+
+	if (clearRefs.is_open())
+		clearRefs << "5";
+#endif
+}
+
+// Peak resident memory of the whole process in kilobytes: since the last reset on Linux, and since the process
+// started everywhere else (Windows can't reset PeakWorkingSetSize, nor macOS ru_maxrss)
+long long peakResidentKilobytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize / 1024;
+
+	return 0;
+#elif defined(__linux__)
+	ifstream status("/proc/self/status");
+	string line;
+
+	while (getline(status, line)) {
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return atoll(line.c_str() + 6);
+	}
+
+	return 0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024; // Bytes on macOS
+#endif
+}
+
+// Max segment tree over the remaining capacity of the sprints (in delivery order), used to find the first sprint in
+// a range that a story fits into in O(log sprints)
+class SprintCapacityTree {
+public:
+	int size = 1;
+	vector<int> tree;
+
+	SprintCapacityTree(vector<int> remainingCapacity) {
+		while (size < remainingCapacity.size())
+			size *= 2;
+
+		tree.assign(2 * size, INT_MIN);
+
+		for (int i = 0; i < remainingCapacity.size(); ++i)
+			tree[size + i] = remainingCapacity[i];
+
+		for (int node = size - 1; node > 0; --node)
+			tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+	}
+
+	void update(int index, int remainingCapacity) {
+		int node = size + index;
+		tree[node] = remainingCapacity;
+
+		for (node /= 2; node > 0; node /= 2)
+			tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+	}
+
+	// Returns the first index in [from, to] with at least the given remaining capacity (-1 if there isn't one)
+	int firstFit(int from, int to, int storyPoints, int node = 1, int nodeFrom = 0, int nodeTo = -1) {
+		if (nodeTo == -1)
+			nodeTo = size - 1;
+
+		if (nodeTo < from || nodeFrom > to || tree[node] < storyPoints)
+			return -1;
+
+		if (nodeFrom == nodeTo)
+			return nodeFrom;
+
+		int middle = (nodeFrom + nodeTo) / 2;
+		int found = firstFit(from, to, storyPoints, 2 * node, nodeFrom, middle);
+
+		if (found != -1)
+			return found;
+
+		return firstFit(from, to, storyPoints, 2 * node + 1, middle + 1, nodeTo);
+	}
+};
+
+// Incremental propagation of the sprint windows the dependencies imply: each story keeps the earliest and latest
+// sprint it can still be delivered in (as ranks in delivery order), and each sprint the capacity it has left
+// Delivering a story pushes the earliest sprint of its dependees past it, and pulls the latest sprint of its
+// dependencies (which it now requires) before it; leaving a story in the product backlog pushes its dependees past
+// the last sprint, so they can't be delivered either. Each change is carried along the CSR edges only as far as
+// windows actually move
+// Every change is recorded on a trail, so a search can undo back to a checkpoint in time proportional to the changes
+class SprintWindowPropagator {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	int numberOfSprints = 0;
+
+	vector<int> earliest; // numberOfSprints if the story can't be delivered
+	vector<int> latest;
+	vector<int> required; // 1 for stories delivered, or needed by a delivered story
+	vector<int> residualCapacity; // Of each sprint
+
+	bool trailing = true; // Whether changes are recorded for undo
+	vector<pair<int*, int>> trail; // Old value of each changed entry
+	vector<int> pending; // Scratch stack of stories whose windows changed
+
+	SprintWindowPropagator() {};
+
+	// capacities are the sprint capacities in delivery order
+	// Stories start no earlier than their longest chain of dependencies and only in sprints they fit, as in the presolve
+	SprintWindowPropagator(shared_ptr<const PlanningInstance> instance, const vector<int>& capacities) {
+		this->instance = instance;
+		this->numberOfSprints = capacities.size();
+		this->residualCapacity = capacities;
+
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+
+		earliest.assign(numberOfStories, numberOfSprints); // Stories on a dependency cycle are never ordered
+		latest.assign(numberOfStories, numberOfSprints - 1);
+		required.assign(numberOfStories, 0);
+
+		for (int storyNumber : stories.topologicalOrder()) {
+			int first = 0;
+
+			for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d)
+				first = max(first, deliverable(stories.dependencies[d]) ? earliest[stories.dependencies[d]] + 1 : numberOfSprints);
+
+			while (first < numberOfSprints && capacities[first] < stories.storyPoints[storyNumber])
+				++first;
+
+			earliest[storyNumber] = first;
+
+			while (latest[storyNumber] >= first && capacities[latest[storyNumber]] < stories.storyPoints[storyNumber])
+				--latest[storyNumber];
+		}
+	}
+
+	bool deliverable(int storyNumber) {
+		return earliest[storyNumber] <= latest[storyNumber];
+	}
+
+	// Whether the story could go in the sprint right now
+	bool fits(int storyNumber, int rank) {
+		return rank >= earliest[storyNumber] && rank <= latest[storyNumber] && residualCapacity[rank] >= instance->storyPoints[storyNumber];
+	}
+
+	int checkpoint() {
+		return trail.size();
+	}
+
+	// Restores every window and capacity changed since the checkpoint
+	void undo(int mark) {
+		while (trail.size() > mark) {
+			*trail.back().first = trail.back().second;
+			trail.pop_back();
+		}
+	}
+
+	void set(vector<int>& values, int index, int value) {
+		if (trailing)
+			trail.push_back(make_pair(&values[index], values[index]));
+
+		values[index] = value;
+	}
+
+	// Delivers the story in the sprint and propagates, returns false if that leaves a sprint over capacity or a
+	// required story with no sprint (the changes are made either way, for the caller to undo)
+	bool deliver(int storyNumber, int rank) {
+		const PlanningInstance& stories = *instance;
+		bool feasible = fits(storyNumber, rank);
+
+		set(residualCapacity, rank, residualCapacity[rank] - stories.storyPoints[storyNumber]);
+		set(required, storyNumber, 1);
+
+		if (earliest[storyNumber] != rank)
+			set(earliest, storyNumber, rank);
+
+		if (latest[storyNumber] != rank)
+			set(latest, storyNumber, rank);
+
+		return propagateEarliest(storyNumber) && propagateLatest(storyNumber) && feasible;
+	}
+
+	// Leaves the story in the product backlog and propagates, returns false if a delivered story needs it
+	bool exclude(int storyNumber) {
+		if (earliest[storyNumber] != numberOfSprints)
+			set(earliest, storyNumber, numberOfSprints);
+
+		return propagateEarliest(storyNumber) && !required[storyNumber];
+	}
+
+	// Pushes the earliest sprints of the dependees of the story (and on through theirs) past its own
+	bool propagateEarliest(int storyNumber) {
+		const PlanningInstance& stories = *instance;
+		bool feasible = true;
+
+		pending.push_back(storyNumber);
+
+		while (!pending.empty()) {
+			int changed = pending.back();
+			pending.pop_back();
+
+			int first = deliverable(changed) ? min(earliest[changed] + 1, numberOfSprints) : numberOfSprints;
+
+			for (int d = stories.dependeeOffsets[changed]; d < stories.dependeeOffsets[changed + 1]; ++d) {
+				int dependeeNumber = stories.dependees[d];
+
+				if (earliest[dependeeNumber] >= first)
+					continue;
+
+				set(earliest, dependeeNumber, first);
+				feasible = feasible && (deliverable(dependeeNumber) || !required[dependeeNumber]);
+				pending.push_back(dependeeNumber);
+			}
+		}
+
+		return feasible;
+	}
+
+	// Requires the dependencies of the (required) story, and pulls their latest sprints (and on through theirs)
+	// before its own
+	bool propagateLatest(int storyNumber) {
+		const PlanningInstance& stories = *instance;
+		bool feasible = true;
+
+		pending.push_back(storyNumber);
+
+		while (!pending.empty()) {
+			int changed = pending.back();
+			pending.pop_back();
+
+			for (int d = stories.dependencyOffsets[changed]; d < stories.dependencyOffsets[changed + 1]; ++d) {
+				int dependencyNumber = stories.dependencies[d];
+				bool moved = false;
+
+				if (!required[dependencyNumber]) {
+					set(required, dependencyNumber, 1);
+					moved = true;
+				}
+
+				if (latest[dependencyNumber] > latest[changed] - 1) {
+					set(latest, dependencyNumber, latest[changed] - 1);
+					moved = true;
+				}
+
+				if (moved) {
+					feasible = feasible && deliverable(dependencyNumber);
+					pending.push_back(dependencyNumber);
+				}
+			}
+		}
+
+		return feasible;
+	}
+};
+
+// Orders the greedy insertion can use (stories always wait for their dependencies, whatever the order)
+enum PriorityRule {
+	InputOrder, // The order the stories are given in
+	ValueDensity, // Business value per story point, highest first
+	CriticalPath, // Story points on the longest chain of dependees below the story, longest first
+	MostDependees // Number of dependees, most first
+};
+
+// Inserts each story into its first valid sprint (or the product backlog), highest priority first among the stories
+// whose dependencies have already been inserted
+// Each insertion finds its sprint with the capacity tree within the story's propagated window, so the whole pass is
+// O((stories + dependencies) log stories) instead of probing every sprint with validInsert
+// Sprints marked in closedSprints (by sprint position, empty for none) keep what they have and take nothing more
+void insertStoriesByPriority(const vector<int>& storyNumbers, Roadmap& roadmap, const vector<double>& priority, const vector<bool>& closedSprints = vector<bool>()) {
+	const PlanningInstance& stories = *roadmap.instance;
+
+	// The real sprints in delivery order, and where each sprint position comes in that order
+	vector<int> deliveryOrder;
+	vector<int> deliveryRank(roadmap.sprints.size(), -1);
+	int backlogPosition = -1;
+
+	for (int i = 0; i < roadmap.sprints.size(); ++i) {
+		if (roadmap.sprints[i].sprintNumber == -1)
+			backlogPosition = i;
+		else
+			deliveryOrder.push_back(i);
+	}
+
+	sort(deliveryOrder.begin(), deliveryOrder.end(), [&](int a, int b) {
+		return roadmap.sprints[a] < roadmap.sprints[b];
+	});
+
+	vector<int> capacities;
+
+	for (int rank = 0; rank < deliveryOrder.size(); ++rank) {
+		deliveryRank[deliveryOrder[rank]] = rank;
+		capacities.push_back(roadmap.sprints[deliveryOrder[rank]].sprintCapacity);
+	}
+
+	// Nothing is undone, so the propagation doesn't keep a trail
+	SprintWindowPropagator windows(roadmap.instance, capacities);
+	windows.trailing = false;
+
+	// Only dependencies that are also being inserted are waited for
+	vector<int> waitingOn(stories.numberOfStories(), -1);
+
+	for (int storyNumber : storyNumbers)
+		waitingOn[storyNumber] = 0;
+
+	// The stories already in the roadmap, and those left out of it, narrow the windows of the stories being inserted
+	for (int storyNumber = 0; storyNumber < stories.numberOfStories(); ++storyNumber) {
+		if (waitingOn[storyNumber] != -1)
+			continue;
+
+		if (roadmap.storySprint[storyNumber] != -1 && roadmap.storySprint[storyNumber] != backlogPosition)
+			windows.deliver(storyNumber, deliveryRank[roadmap.storySprint[storyNumber]]);
+		else
+			windows.exclude(storyNumber);
+	}
+
+	// Closed sprints are left out of the capacity tree (as its padding is), so no story fits in them
+	vector<int> openCapacity = windows.residualCapacity;
+
+	for (int rank = 0; rank < deliveryOrder.size(); ++rank) {
+		if (!closedSprints.empty() && closedSprints[deliveryOrder[rank]])
+			openCapacity[rank] = INT_MIN;
+	}
+
+	SprintCapacityTree capacityTree(openCapacity);
+
+	for (int storyNumber : storyNumbers) {
+		for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d) {
+			if (waitingOn[stories.dependees[d]] != -1)
+				++waitingOn[stories.dependees[d]];
+		}
+	}
+
+	auto lowerPriority = [&](int a, int b) { return priority[a] < priority[b]; };
+	vector<int> readyStories;
+
+	for (int storyNumber : storyNumbers) {
+		if (waitingOn[storyNumber] == 0)
+			readyStories.push_back(storyNumber);
+	}
+
+	make_heap(readyStories.begin(), readyStories.end(), lowerPriority);
+
+	while (!readyStories.empty()) {
+		pop_heap(readyStories.begin(), readyStories.end(), lowerPriority);
+		int storyNumber = readyStories.back();
+		int storyPoints = stories.storyPoints[storyNumber];
+		readyStories.pop_back();
+
+		waitingOn[storyNumber] = -1;
+
+		// The window already has the story after all of its dependencies and before any dependees in a sprint
+		int rank = windows.deliverable(storyNumber) ? capacityTree.firstFit(windows.earliest[storyNumber], windows.latest[storyNumber], storyPoints) : -1;
+
+		if (rank != -1) {
+			roadmap.addStoryToSprint(storyNumber, roadmap.sprints[deliveryOrder[rank]]);
+			windows.deliver(storyNumber, rank);
+			capacityTree.update(rank, windows.residualCapacity[rank]);
+		}
+		else {
+			windows.exclude(storyNumber);
+
+			if (backlogPosition != -1)
+				roadmap.addStoryToSprint(storyNumber, roadmap.sprints[backlogPosition]);
+		}
+
+		for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d) {
+			int dependeeNumber = stories.dependees[d];
+
+			if (waitingOn[dependeeNumber] > 0 && --waitingOn[dependeeNumber] == 0) {
+				readyStories.push_back(dependeeNumber);
+				push_heap(readyStories.begin(), readyStories.end(), lowerPriority);
+			}
+		}
+	}
+
+	// Stories on a dependency cycle never become ready, and can only go in the product backlog
+	for (int storyNumber : storyNumbers) {
+		if (waitingOn[storyNumber] > 0 && backlogPosition != -1)
+			roadmap.addStoryToSprint(storyNumber, roadmap.sprints[backlogPosition]);
+	}
+}
+
+// Greedily inserts the stories into the roadmap, ordered by the priority rule (ties are broken by the order of
+// storyNumbers), leaving the closed sprints as they are
+// The roadmap is taken by value so callers can move a fresh roadmap in and get the filled one back without a copy
+Roadmap greedyInsertStories(const vector<int>& storyNumbers, Roadmap roadmap, PriorityRule rule = InputOrder, const vector<bool>& closedSprints = vector<bool>()) {
+	const PlanningInstance& stories = *roadmap.instance;
+	int numberOfStories = stories.numberOfStories();
+	int numberOfStoriesToInsert = storyNumbers.size();
+
+	vector<double> priority(numberOfStories, 0);
+
+	if (rule == CriticalPath) {
+		// Longest chain of story points through each story's dependees, computed in reverse dependency order
+		vector<int> order = stories.topologicalOrder();
+
+		for (int position = order.size() - 1; position >= 0; --position) {
+			int storyNumber = order[position];
+			double longestDependeeChain = 0;
+
+			for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d)
+				longestDependeeChain = max(longestDependeeChain, priority[stories.dependees[d]]);
+
+			priority[storyNumber] = stories.storyPoints[storyNumber] + longestDependeeChain;
+		}
+	}
+
+	for (int position = 0; position < numberOfStoriesToInsert; ++position) {
+		int storyNumber = storyNumbers[position];
+		int businessValue = stories.businessValue[storyNumber];
+		int storyPoints = stories.storyPoints[storyNumber];
+
+		// A tiny position-based term breaks ties in favour of the input order
+		double tieBreak = 1 - (double)position / (numberOfStoriesToInsert + 1);
+
+		if (rule == InputOrder)
+			priority[storyNumber] = tieBreak;
+		else if (rule == ValueDensity)
+			priority[storyNumber] = (storyPoints > 0 ? (double)businessValue / storyPoints : 1e9 + businessValue) + tieBreak * 1e-9;
+		else if (rule == CriticalPath)
+			priority[storyNumber] += tieBreak * 1e-3;
+		else
+			priority[storyNumber] = stories.dependeeOffsets[storyNumber + 1] - stories.dependeeOffsets[storyNumber] + tieBreak * 1e-3;
+	}
+
+	insertStoriesByPriority(storyNumbers, roadmap, priority, closedSprints);
+
+	return roadmap;
+}
+
+// Greedily inserts every story into the roadmap, in story number order for ties
+Roadmap greedyInsertStories(Roadmap roadmap, PriorityRule rule = InputOrder) {
+	vector<int> storyNumbers(roadmap.numberOfStories());
+
+	for (int j = 0; j < storyNumbers.size(); ++j)
+		storyNumbers[j] = j;
+
+	return greedyInsertStories(storyNumbers, move(roadmap), rule);
+}
+
+// Greedily inserts the stories in an order shuffled by the generator
+Roadmap randomRoadmap(shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, mt19937& generator) {
+	Roadmap roadmap(instance, sprintData);
+	vector<int> shuffledStories(instance->numberOfStories());
+
+	for (int j = 0; j < shuffledStories.size(); ++j)
+		shuffledStories[j] = j;
+
+	shuffle(shuffledStories.begin(), shuffledStories.end(), generator);
+	return greedyInsertStories(shuffledStories, move(roadmap));
+}
+
+// Finds the interchangeable parts of an instance, which give many roadmaps of equal value and so blow up the search
+// Twin stories have the same business value, story points, dependencies and dependees, so swapping their sprints
+// gives another roadmap of the same value: each class of twins can be kept in story number order, with a twin never
+// delivered after a higher-numbered twin. Identical sprints have the same capacity and bonus, and when no story with
+// dependencies or dependees could be in them, swapping their contents changes nothing either, so each class of them
+// can be kept in order of load
+// Both orders hold at once, since sorting twins into order moves equal story points between sprints
+class SymmetryAnalysis {
+public:
+	vector<vector<int>> storyClasses; // Twin stories by story number (only classes of two or more)
+	vector<vector<int>> sprintClasses; // Positions of interchangeable sprints in delivery order (only classes of two or more)
+
+	vector<int> previousTwin; // Next lower-numbered twin of each story (-1 if there is none)
+	vector<int> nextTwin; // Next higher-numbered twin of each story (-1 if there is none)
+	vector<int> sprintClass; // Class of each sprint position (-1 if the sprint isn't interchangeable with another)
+
+	SymmetryAnalysis(const PlanningInstance& stories, vector<Sprint>& sprintData) {
+		int numberOfStories = stories.numberOfStories();
+
+		previousTwin.assign(numberOfStories, -1);
+		nextTwin.assign(numberOfStories, -1);
+		sprintClass.assign(sprintData.size(), -1);
+
+		// Stories are twins when their keys (value, points, then the sorted dependencies and dependees) are equal
+		map<vector<int>, int> classOfKey;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			vector<int> key = { stories.businessValue[j], stories.storyPoints[j], stories.dependencyOffsets[j + 1] - stories.dependencyOffsets[j] };
+			int dependeesStart = 3 + key[2];
+
+			key.insert(key.end(), stories.dependencies.begin() + stories.dependencyOffsets[j], stories.dependencies.begin() + stories.dependencyOffsets[j + 1]);
+			key.insert(key.end(), stories.dependees.begin() + stories.dependeeOffsets[j], stories.dependees.begin() + stories.dependeeOffsets[j + 1]);
+			sort(key.begin() + 3, key.begin() + dependeesStart);
+			sort(key.begin() + dependeesStart, key.end());
+
+			auto found = classOfKey.find(key);
+
+			if (found == classOfKey.end()) {
+				classOfKey[key] = storyClasses.size();
+				storyClasses.push_back({ j });
+			}
+			else {
+				vector<int>& twins = storyClasses[found->second];
+
+				previousTwin[j] = twins.back();
+				nextTwin[twins.back()] = j;
+				twins.push_back(j);
+			}
+		}
+
+		storyClasses.erase(remove_if(storyClasses.begin(), storyClasses.end(), [](const vector<int>& twins) {
+			return twins.size() < 2;
+		}), storyClasses.end());
+
+		// A story can't be in a sprint before the one given by its longest chain of dependencies (stories on a
+		// dependency cycle can't be in any)
+		vector<int> depth(numberOfStories, INT_MAX);
+
+		for (int storyNumber : stories.topologicalOrder()) {
+			depth[storyNumber] = 0;
+
+			for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d)
+				depth[storyNumber] = max(depth[storyNumber], depth[stories.dependencies[d]] + 1);
+		}
+
+		// Sprints with a story that has dependencies or dependees could break them when swapped, so they stay out
+		map<pair<int, int>, vector<int>> identicalSprints; // (capacity, bonus) to positions
+
+		for (int i = 0; i < sprintData.size(); ++i) {
+			if (sprintData[i].sprintNumber == -1)
+				continue;
+
+			bool interchangeable = true;
+
+			for (int j = 0; j < numberOfStories && interchangeable; ++j) {
+				bool isolated = stories.dependencyOffsets[j] == stories.dependencyOffsets[j + 1] && stories.dependeeOffsets[j] == stories.dependeeOffsets[j + 1];
+
+				if (!isolated && stories.storyPoints[j] <= sprintData[i].sprintCapacity && depth[j] <= sprintData[i].sprintNumber)
+					interchangeable = false;
+			}
+
+			if (interchangeable)
+				identicalSprints[{ sprintData[i].sprintCapacity, sprintData[i].sprintBonus }].push_back(i);
+		}
+
+		for (auto& identical : identicalSprints) {
+			vector<int>& positions = identical.second;
+
+			if (positions.size() < 2)
+				continue;
+
+			sort(positions.begin(), positions.end(), [&](int a, int b) {
+				return sprintData[a].sprintNumber < sprintData[b].sprintNumber;
+			});
+
+			for (int i : positions)
+				sprintClass[i] = sprintClasses.size();
+
+			sprintClasses.push_back(positions);
+		}
+	}
+
+	// Puts a roadmap (the sprint position of each story, -1 for none) in the order the symmetry breaking keeps, without
+	// changing its value: interchangeable sprints swap contents until their loads fall, then twins swap sprints
+	vector<int> orderRoadmap(vector<int> storySprint, vector<Sprint>& sprintData, const PlanningInstance& stories) {
+		for (vector<int>& positions : sprintClasses) {
+			vector<long long> load(sprintData.size(), 0);
+
+			for (int j = 0; j < storySprint.size(); ++j) {
+				if (storySprint[j] != -1)
+					load[storySprint[j]] += stories.storyPoints[j];
+			}
+
+			vector<int> byLoad = positions;
+			stable_sort(byLoad.begin(), byLoad.end(), [&](int a, int b) {
+				return load[a] > load[b];
+			});
+
+			vector<int> newPosition(sprintData.size());
+
+			for (int i = 0; i < sprintData.size(); ++i)
+				newPosition[i] = i;
+
+			for (int k = 0; k < positions.size(); ++k)
+				newPosition[byLoad[k]] = positions[k];
+
+			for (int j = 0; j < storySprint.size(); ++j) {
+				if (storySprint[j] != -1)
+					storySprint[j] = newPosition[storySprint[j]];
+			}
+		}
+
+		// Stories not in a real sprint sort last
+		auto deliveryRank = [&](int position) {
+			return position == -1 || sprintData[position].sprintNumber == -1 ? INT_MAX : sprintData[position].sprintNumber;
+		};
+
+		for (vector<int>& twins : storyClasses) {
+			vector<int> positions;
+
+			for (int j : twins)
+				positions.push_back(storySprint[j]);
+
+			stable_sort(positions.begin(), positions.end(), [&](int a, int b) {
+				return deliveryRank(a) < deliveryRank(b);
+			});
+
+			for (int k = 0; k < twins.size(); ++k)
+				storySprint[twins[k]] = positions[k];
+		}
+
+		return storySprint;
+	}
+
+	int twinStories() {
+		int twins = 0;
+
+		for (vector<int>& twinClass : storyClasses)
+			twins += twinClass.size();
+
+		return twins;
+	}
+
+	string describe() {
+		return to_string(storyClasses.size()) + " classes of twin stories (" + to_string(twinStories()) + " stories), "
+			+ to_string(sprintClasses.size()) + " classes of interchangeable sprints";
+	}
+};
+
+// Exact depth-first branch-and-bound over story-to-sprint assignments (an alternative to CPLEX)
+class BranchAndBoundSolver {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	vector<Sprint> sprintData; // All sprints, including the product backlog
+	vector<Sprint> sprints; // The sprints stories can be delivered in, in delivery order
+
+	double timeLimit; // Seconds (0 means no limit)
+	bool breakSymmetry = true; // Keep twin stories (and, when there are none, interchangeable sprints) in order
+	bool provedOptimal = false;
+	long long nodesExplored = 0;
+
+	vector<int> branchingOrder; // Stories in dependency order, so a story's dependencies are always decided first
+	vector<int> densityOrder; // Stories by business value per story point (highest first), used by the bound
+	vector<int> bonusOrder; // Sprint positions by bonus (highest first)
+
+	vector<char> decided;
+	vector<int> assignedSprint; // Sprint position of each decided story (-1 means the product backlog)
+	SprintWindowPropagator windows; // Sprint windows of the undecided stories and remaining capacities, undone on backtracking
+	vector<int> boundCapacity; // Scratch copy of the remaining capacities used when computing the bound
+
+	// Only filled in by solve when breaking symmetry
+	vector<int> previousTwin; // See SymmetryAnalysis
+	vector<int> nextTwin;
+	vector<int> sprintClass; // Class of interchangeable sprints of each sprint position (-1 if none)
+
+	long long currentValue = 0;
+	long long bestValue = 0;
+	vector<int> bestAssignment;
+
+	chrono::steady_clock::time_point startTime;
+	bool timedOut = false;
+
+	// A node on the path from the root: the story it decides, the sprints it tries (a range of candidateSprints) and
+	// how to undo the child being explored
+	struct SearchFrame {
+		int position; // In branchingOrder
+		int firstCandidate, nextCandidate, lastCandidate;
+		bool mustBeDelivered;
+		bool backlogTried = false;
+		int childMark = -1; // Trail checkpoint before the current child (-1 if there is none)
+		long long childValue = 0; // Value the current child added
+	};
+
+	vector<SearchFrame> frames;
+	vector<int> candidateSprints; // Sprints of every open node, in frame order
+
+	BranchAndBoundSolver(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprintData, double timeLimit) {
+		this->instance = instance;
+		this->sprintData = sprintData;
+		this->timeLimit = timeLimit;
+
+		for (Sprint sprint : sprintData) {
+			if (sprint.sprintNumber != -1)
+				sprints.push_back(sprint);
+		}
+
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+		int numberOfSprints = sprints.size();
+
+		// Zero-point stories first (by business value), then by business value per story point
+		// Zero-point stories need their own case: cross-multiplying makes a story with no value and no points tie with
+		// every other story, which isn't a strict weak ordering, and a badly sorted densityOrder breaks the bound
+		auto denser = [&](int a, int b) {
+			bool aFree = stories.storyPoints[a] == 0;
+			bool bFree = stories.storyPoints[b] == 0;
+
+			if (aFree || bFree)
+				return aFree != bFree ? aFree : stories.businessValue[a] > stories.businessValue[b];
+
+			return (long long)stories.businessValue[a] * stories.storyPoints[b]
+				> (long long)stories.businessValue[b] * stories.storyPoints[a];
+		};
+
+		for (int j = 0; j < numberOfStories; ++j)
+			densityOrder.push_back(j);
+
+		sort(densityOrder.begin(), densityOrder.end(), denser);
+
+		// Branch on the densest story whose dependencies have all been branched on, as in a knapsack search
+		vector<int> unorderedDependencies(numberOfStories);
+		auto sparser = [&](int a, int b) { return denser(b, a); };
+		priority_queue<int, vector<int>, decltype(sparser)> readyStories(sparser);
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			unorderedDependencies[j] = stories.dependencyOffsets[j + 1] - stories.dependencyOffsets[j];
+
+			if (unorderedDependencies[j] == 0)
+				readyStories.push(j);
+		}
+
+		while (!readyStories.empty()) {
+			int storyNumber = readyStories.top();
+			readyStories.pop();
+			branchingOrder.push_back(storyNumber);
+
+			for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d) {
+				if (--unorderedDependencies[stories.dependees[d]] == 0)
+					readyStories.push(stories.dependees[d]);
+			}
+		}
+
+		for (int i = 0; i < numberOfSprints; ++i)
+			bonusOrder.push_back(i);
+
+		stable_sort(bonusOrder.begin(), bonusOrder.end(), [&](int a, int b) {
+			return sprints[a].sprintBonus > sprints[b].sprintBonus;
+		});
+
+		decided.assign(numberOfStories, false);
+		assignedSprint.assign(numberOfStories, -1);
+		bestAssignment.assign(numberOfStories, -1);
+
+		vector<int> capacities;
+
+		for (Sprint sprint : sprints)
+			capacities.push_back(sprint.sprintCapacity);
+
+		windows = SprintWindowPropagator(instance, capacities);
+	}
+
+	// Upper bound on the value the undecided stories can still add
+	// Relaxes the problem to fractional story points flowing into sprints, ignoring sprint order. Because each
+	// story/sprint value is the product (value per point) * (sprint bonus), filling the highest-bonus sprints with
+	// the densest stories first solves that relaxation exactly
+	double upperBound() {
+		const PlanningInstance& stories = *instance;
+		boundCapacity = windows.residualCapacity;
+
+		double bound = 0;
+		int bonusPosition = 0;
+		int highestBonus = bonusOrder.empty() ? 0 : sprints[bonusOrder[0]].sprintBonus;
+
+		for (int storyNumber : densityOrder) {
+			// Decided stories are already counted, and stories with an empty window (after a dependency in the
+			// backlog or too late to leave room for them, or too big for any sprint) can't be delivered
+			if (decided[storyNumber] || !windows.deliverable(storyNumber))
+				continue;
+
+			if (stories.storyPoints[storyNumber] == 0) {
+				bound += (double)stories.businessValue[storyNumber] * highestBonus;
+				continue;
+			}
+
+			double valuePerPoint = (double)stories.businessValue[storyNumber] / stories.storyPoints[storyNumber];
+			int pointsToPlace = stories.storyPoints[storyNumber];
+
+			while (pointsToPlace > 0 && bonusPosition < bonusOrder.size()) {
+				int sprintPosition = bonusOrder[bonusPosition];
+				int pointsPlaced = min(pointsToPlace, boundCapacity[sprintPosition]);
+
+				bound += valuePerPoint * sprints[sprintPosition].sprintBonus * pointsPlaced;
+				boundCapacity[sprintPosition] -= pointsPlaced;
+				pointsToPlace -= pointsPlaced;
+
+				if (boundCapacity[sprintPosition] == 0)
+					++bonusPosition;
+			}
+		}
+
+		return bound;
+	}
+
+	// Opens the search node that decides the story at the given position of branchingOrder, pushing its frame (and
+	// the sprints it will try) unless the node is a leaf, is pruned or the time limit has been reached
+	void openNode(int position) {
+		++nodesExplored;
+
+		// Leaving every undecided story in the product backlog is always feasible, so every node is a solution
+		if (currentValue > bestValue) {
+			bestValue = currentValue;
+			bestAssignment = assignedSprint;
+		}
+
+		if (position == branchingOrder.size())
+			return;
+
+		if (timeLimit > 0 && nodesExplored % 4096 == 0
+			&& chrono::duration<double>(chrono::steady_clock::now() - startTime).count() > timeLimit)
+			timedOut = true;
+
+		if (timedOut)
+			return;
+
+		// Prune if the undecided stories can't beat the best roadmap found so far (values are integers)
+		if (currentValue + (long long)floor(upperBound() + 1e-6) <= bestValue)
+			return;
+
+		const PlanningInstance& stories = *instance;
+		int storyNumber = branchingOrder[position];
+
+		decided[storyNumber] = true;
+
+		// A story can't be delivered after a decided higher-numbered twin, or before (or without) a lower-numbered one
+		int latestSprint = sprints.size() - 1;
+		bool mustBeDelivered = false;
+		bool mustStayInBacklog = false;
+		int earliestTwinSprint = 0;
+
+		if (breakSymmetry) {
+			int previous = previousTwin[storyNumber];
+			int next = nextTwin[storyNumber];
+
+			if (previous != -1 && decided[previous]) {
+				mustStayInBacklog = assignedSprint[previous] == -1;
+				earliestTwinSprint = assignedSprint[previous];
+			}
+
+			if (next != -1 && decided[next] && assignedSprint[next] != -1) {
+				mustBeDelivered = true;
+				latestSprint = assignedSprint[next];
+			}
+		}
+
+		SearchFrame frame;
+		frame.position = position;
+		frame.mustBeDelivered = mustBeDelivered;
+		frame.firstCandidate = frame.nextCandidate = candidateSprints.size();
+
+		// Every child is undone before the next is tried, so the sprints can all be chosen now from this node's state
+		if (windows.deliverable(storyNumber) && !mustStayInBacklog) {
+			// The window has the story after all of its dependencies
+			int earliestSprint = max(windows.earliest[storyNumber], earliestTwinSprint);
+
+			latestSprint = min(latestSprint, windows.latest[storyNumber]);
+
+			// Interchangeable sprints with the same capacity left lead to the same roadmaps, so only the first is tried
+			vector<pair<int, int>> triedSprints; // (class, remaining capacity)
+
+			// Try the sprints the story fits into, most valuable first
+			for (int sprintPosition : bonusOrder) {
+				if (sprintPosition < earliestSprint || sprintPosition > latestSprint || windows.residualCapacity[sprintPosition] < stories.storyPoints[storyNumber])
+					continue;
+
+				if (sprintClass[sprintPosition] != -1) {
+					pair<int, int> tried = { sprintClass[sprintPosition], windows.residualCapacity[sprintPosition] };
+
+					if (find(triedSprints.begin(), triedSprints.end(), tried) != triedSprints.end())
+						continue;
+
+					triedSprints.push_back(tried);
+				}
+
+				candidateSprints.push_back(sprintPosition);
+			}
+		}
+
+		frame.lastCandidate = candidateSprints.size();
+		frames.push_back(frame);
+	}
+
+	// Depth-first search over the stories in branchingOrder, with the path kept in frames rather than on the call
+	// stack, so backlogs of any size can't overflow the stack
+	void search() {
+		const PlanningInstance& stories = *instance;
+
+		frames.clear();
+		frames.reserve(branchingOrder.size());
+		candidateSprints.clear();
+
+		openNode(0);
+
+		while (!frames.empty()) {
+			SearchFrame& frame = frames.back();
+			int position = frame.position;
+			int storyNumber = branchingOrder[position];
+
+			// Back from a child: undo it
+			if (frame.childMark != -1) {
+				currentValue -= frame.childValue;
+				windows.undo(frame.childMark);
+				frame.childMark = -1;
+			}
+
+			if (!timedOut && frame.nextCandidate < frame.lastCandidate) {
+				int sprintPosition = candidateSprints[frame.nextCandidate++];
+				long long storyValue = (long long)stories.businessValue[storyNumber] * sprints[sprintPosition].sprintBonus;
+
+				frame.childMark = windows.checkpoint();
+				frame.childValue = storyValue;
+
+				assignedSprint[storyNumber] = sprintPosition;
+				currentValue += storyValue;
+
+				// Dependencies are decided first, so delivering the story can only narrow undecided windows
+				windows.deliver(storyNumber, sprintPosition);
+				openNode(position + 1);
+				continue;
+			}
+
+			if (!frame.backlogTried) {
+				// Leave the story in the product backlog, which rules out all of its dependees
+				frame.backlogTried = true;
+				assignedSprint[storyNumber] = -1;
+
+				if (!timedOut && !frame.mustBeDelivered) {
+					frame.childMark = windows.checkpoint();
+					frame.childValue = 0;
+
+					windows.exclude(storyNumber);
+					openNode(position + 1);
+					continue;
+				}
+			}
+
+			decided[storyNumber] = false;
+			candidateSprints.resize(frame.firstCandidate);
+			frames.pop_back();
+		}
+	}
+
+	// Searches for the highest-value roadmap, starting from the given feasible roadmap as the incumbent
+	Roadmap solve(Roadmap incumbent) {
+		int numberOfStories = instance->numberOfStories();
+		map<int, int> sprintPositions;
+
+		for (int i = 0; i < sprints.size(); ++i)
+			sprintPositions[sprints[i].sprintNumber] = i;
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+			if (incumbent.isAssigned(storyNumber) && incumbent.assignedSprint(storyNumber).sprintNumber != -1)
+				bestAssignment[storyNumber] = sprintPositions[incumbent.assignedSprint(storyNumber).sprintNumber];
+		}
+
+		bestValue = incumbent.calculateValue();
+
+		previousTwin.assign(numberOfStories, -1);
+		nextTwin.assign(numberOfStories, -1);
+		sprintClass.assign(sprints.size(), -1);
+
+		if (breakSymmetry) {
+			SymmetryAnalysis symmetry(*instance, sprintData);
+
+			previousTwin = symmetry.previousTwin;
+			nextTwin = symmetry.nextTwin;
+
+			// Trying only one of several equal sprints could reorder twins already decided, so sprints are only
+			// treated as interchangeable when there are no twins
+			if (symmetry.storyClasses.empty()) {
+				for (int i = 0; i < sprintData.size(); ++i) {
+					if (symmetry.sprintClass[i] != -1)
+						sprintClass[sprintPositions[sprintData[i].sprintNumber]] = symmetry.sprintClass[i];
+				}
+			}
+		}
+
+		startTime = chrono::steady_clock::now();
+		search();
+		provedOptimal = !timedOut;
+
+		Roadmap roadmap(instance, sprintData);
+		Sprint productBacklog = Sprint(-1, 0, 0);
+
+		for (Sprint sprint : sprintData) {
+			if (sprint.sprintNumber == -1)
+				productBacklog = sprint;
+		}
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+			if (bestAssignment[storyNumber] == -1)
+				roadmap.addStoryToSprint(storyNumber, productBacklog);
+			else
+				roadmap.addStoryToSprint(storyNumber, sprints[bestAssignment[storyNumber]]);
+		}
+
+		return roadmap;
+	}
+};
+
+// Exact pseudo-polynomial dynamic program for the instance shapes that reduce to a knapsack over sprint capacity
+// With a single sprint, stories with dependencies can never be delivered and the rest are a 0/1 knapsack. With more
+// sprints and dependencies that form simple chains (at most one dependency and one dependee per story), a chain can
+// only deliver a prefix of its stories, each in a later sprint than the one before, so each chain is a group of
+// options (one per increasing sequence of sprints no longer than the chain) in a knapsack over every capacity
+// There is a cell for every combination of capacities used, so in practice only a few sprints fit in the memory
+// allowed. The winning option of every group at every cell is kept in a few bits, so the roadmap can be read back
+class KnapsackDynamicProgram {
+public:
+	const PlanningInstance& stories;
+	vector<Sprint> sprintData; // All sprints, including the product backlog
+
+	// Larger instances are left to the general solvers
+	static const unsigned long long maximumBytes = 1ULL << 29;
+	static const unsigned long long maximumOperations = 1000000000ULL;
+
+	vector<int> sprintOrder; // Positions of the real sprints in delivery order
+	int backlogPosition = -1;
+	vector<int> capacity; // Of each sprint in delivery order
+	vector<unsigned long long> stride; // Distance between cells one story point apart in each sprint (the last is contiguous)
+	unsigned long long cells = 1; // Product of the capacities plus one (stops growing once it is over maximumBytes)
+
+	vector<vector<int>> chains; // Stories of each group in dependency order, cut to the number of sprints
+	int longestChain = 0;
+
+	// Increasing sequences of sprints (indices into sprintOrder), shortest first and starting with the empty one, so
+	// the options of a chain of length m are the first optionCount[m] sequences, and option 0 is to deliver nothing
+	vector<vector<int>> sequences;
+	vector<unsigned long long> optionCount; // Stops growing once it is over maximumOperations
+
+	int bitsPerChoice = 1; // A power of two, so a choice never straddles two words
+	vector<uint64_t> choices; // bitsPerChoice bits per (group, cell)
+	long long optimalValue = 0;
+
+	KnapsackDynamicProgram(const PlanningInstance& stories, vector<Sprint>& sprintData) : stories(stories) {
+		this->sprintData = sprintData;
+
+		for (int i = 0; i < sprintData.size(); ++i) {
+			if (sprintData[i].sprintNumber == -1)
+				backlogPosition = i;
+			else
+				sprintOrder.push_back(i);
+		}
+
+		sort(sprintOrder.begin(), sprintOrder.end(), [&](int a, int b) {
+			return sprintData[a] < sprintData[b];
+		});
+
+		int numberOfSprints = sprintOrder.size();
+
+		for (int k = 0; k < numberOfSprints; ++k)
+			capacity.push_back(max(0, sprintData[sprintOrder[k]].sprintCapacity));
+
+		stride.assign(numberOfSprints, 1);
+
+		for (int k = numberOfSprints - 1; k >= 0; --k) {
+			stride[k] = cells;
+			cells = min(cells * (capacity[k] + 1), maximumBytes + 1);
+		}
+
+		// Sequences of each length are the binomial coefficients, counted in doubles since they only need comparing
+		// with the limit until they are small enough to be exact
+		optionCount.assign(numberOfSprints + 1, 1);
+		double sequencesOfLength = 1, total = 1;
+
+		for (int m = 1; m <= numberOfSprints; ++m) {
+			sequencesOfLength = sequencesOfLength * (numberOfSprints - m + 1) / m;
+			total += sequencesOfLength;
+			optionCount[m] = total > maximumOperations ? maximumOperations + 1 : (unsigned long long)llround(total);
+		}
+
+		int numberOfStories = stories.numberOfStories();
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			if (stories.dependencyOffsets[j + 1] > stories.dependencyOffsets[j])
+				continue;
+
+			// A later story only fits in a later sprint, and only if the story before it is its sole dependency
+			vector<int> chain = { j };
+
+			while (chain.size() < numberOfSprints && stories.dependeeOffsets[chain.back() + 1] - stories.dependeeOffsets[chain.back()] == 1) {
+				int next = stories.dependees[stories.dependeeOffsets[chain.back()]];
+
+				if (stories.dependencyOffsets[next + 1] - stories.dependencyOffsets[next] != 1)
+					break;
+
+				chain.push_back(next);
+			}
+
+			longestChain = max(longestChain, (int)chain.size());
+			chains.push_back(chain);
+		}
+
+		while ((1ULL << bitsPerChoice) < optionCount[longestChain] && bitsPerChoice < 32)
+			bitsPerChoice *= 2;
+	}
+
+	// Whether the instance has a shape the dynamic program solves exactly, within the memory and work allowed
+	bool applicable() {
+		if (sprintOrder.empty())
+			return false;
+
+		if (sprintOrder.size() > 1) {
+			for (int j = 0; j < stories.numberOfStories(); ++j) {
+				if (stories.dependencyOffsets[j + 1] - stories.dependencyOffsets[j] > 1 || stories.dependeeOffsets[j + 1] - stories.dependeeOffsets[j] > 1)
+					return false;
+			}
+		}
+
+		if (cells > maximumBytes || optionCount[longestChain] > maximumOperations)
+			return false;
+
+		// Every group has at least one option besides nothing, so this also bounds groups * cells below
+		unsigned long long operations = 0;
+
+		for (vector<int>& chain : chains) {
+			operations += cells * (optionCount[chain.size()] - 1);
+
+			if (operations > maximumOperations)
+				return false;
+		}
+
+		// Two tables of values and a table of choices per cell, the sequences, and the choices of every group
+		unsigned long long bytes = cells * (2 * sizeof(long long) + sizeof(uint32_t)) + optionCount[longestChain] * (sizeof(vector<int>) + longestChain * sizeof(int))
+			+ (chains.size() * cells * bitsPerChoice + 63) / 64 * sizeof(uint64_t);
+
+		return bytes <= maximumBytes;
+	}
+
+	// Lists the increasing sequences of sprints, shortest first, up to the length of the longest chain
+	void listSequences() {
+		int numberOfSprints = sprintOrder.size();
+
+		sequences.assign(1, vector<int>());
+
+		for (int length = 1; length <= longestChain; ++length) {
+			vector<int> sequence(length);
+
+			for (int m = 0; m < length; ++m)
+				sequence[m] = m;
+
+			while (true) {
+				sequences.push_back(sequence);
+
+				// Advance the last sprint that still has room after it, and restart the ones after it just behind it
+				int m = length - 1;
+
+				while (m >= 0 && sequence[m] == numberOfSprints - length + m)
+					--m;
+
+				if (m < 0)
+					break;
+
+				++sequence[m];
+
+				for (int n = m + 1; n < length; ++n)
+					sequence[n] = sequence[n - 1] + 1;
+			}
+		}
+	}
+
+	// Story points taken from each sprint and value added by option o of group g, returns false if they don't fit
+	bool option(int g, int o, vector<int>& points, long long& value) {
+		const vector<int>& chain = chains[g];
+		const vector<int>& sequence = sequences[o];
+
+		fill(points.begin(), points.end(), 0);
+		value = 0;
+
+		for (int m = 0; m < sequence.size(); ++m) {
+			points[sequence[m]] = stories.storyPoints[chain[m]];
+			value += (long long)stories.businessValue[chain[m]] * sprintData[sprintOrder[sequence[m]]].sprintBonus;
+
+			if (points[sequence[m]] > capacity[sequence[m]])
+				return false;
+		}
+
+		return true;
+	}
+
+	// Fills the given empty roadmap with an optimal roadmap (the instance must be applicable)
+	Roadmap solve(Roadmap roadmap) {
+		int numberOfSprints = sprintOrder.size();
+		int last = numberOfSprints - 1;
+		int columns = capacity[last] + 1;
+		int numberOfGroups = chains.size();
+
+		listSequences();
+
+		// best[c] is the most value the groups so far can add using at most the capacities of cell c
+		vector<long long> previous(cells, 0);
+		vector<long long> current(cells);
+		vector<uint32_t> choiceRow(cells);
+		vector<int> points(numberOfSprints);
+		vector<int> row(numberOfSprints);
+
+		choices.assign(((unsigned long long)numberOfGroups * cells * bitsPerChoice + 63) / 64, 0);
+
+		for (int g = 0; g < numberOfGroups; ++g) {
+			current = previous;
+			fill(choiceRow.begin(), choiceRow.end(), 0);
+
+			for (int o = 1; o < optionCount[chains[g].size()]; ++o) {
+				long long value;
+
+				if (!option(g, o, points, value))
+					continue;
+
+				// Visit every cell with at least the option's points in each sprint, a row of the last sprint at a
+				// time: the rows are contiguous with no dependence between iterations, so the inner loop vectorizes
+				row = points;
+
+				while (true) {
+					size_t base = 0, shift = 0;
+
+					for (int k = 0; k < last; ++k) {
+						base += row[k] * stride[k];
+						shift += points[k] * stride[k];
+					}
+
+					const long long* from = &previous[base - shift];
+					long long* to = &current[base];
+					uint32_t* choice = &choiceRow[base];
+
+					for (int c = points[last]; c < columns; ++c) {
+						long long candidate = from[c - points[last]] + value;
+						bool better = candidate > to[c];
+
+						to[c] = better ? candidate : to[c];
+						choice[c] = better ? o : choice[c];
+					}
+
+					int k = last - 1;
+
+					while (k >= 0 && row[k] == capacity[k]) {
+						row[k] = points[k];
+						--k;
+					}
+
+					if (k < 0)
+						break;
+
+					++row[k];
+				}
+			}
+
+			unsigned long long offset = (unsigned long long)g * cells * bitsPerChoice;
+
+			for (size_t c = 0; c < cells; ++c) {
+				unsigned long long bit = offset + bitsPerChoice * (unsigned long long)c;
+
+				if (choiceRow[c] != 0)
+					choices[bit >> 6] |= (uint64_t)choiceRow[c] << (bit & 63);
+			}
+
+			swap(previous, current);
+		}
+
+		optimalValue = previous[cells - 1];
+
+		// Walk back through the groups from the full capacities, applying each group's winning option
+		unsigned long long cell = cells - 1;
+		uint64_t mask = (1ULL << bitsPerChoice) - 1;
+
+		for (int g = numberOfGroups - 1; g >= 0; --g) {
+			unsigned long long bit = ((unsigned long long)g * cells + cell) * bitsPerChoice;
+			int o = (choices[bit >> 6] >> (bit & 63)) & mask;
+			long long value;
+
+			option(g, o, points, value);
+
+			for (int m = 0; m < sequences[o].size(); ++m) {
+				roadmap.addStoryToSprint(chains[g][m], sprintData[sprintOrder[sequences[o][m]]]);
+				cell -= points[sequences[o][m]] * stride[sequences[o][m]];
+			}
+		}
+
+		// Everything else is in the product backlog
+		if (backlogPosition != -1) {
+			for (int j = 0; j < stories.numberOfStories(); ++j) {
+				if (!roadmap.isAssigned(j))
+					roadmap.addStoryToSprint(j, sprintData[backlogPosition]);
+			}
+		}
+
+		return roadmap;
+	}
+};
+
+// Returns the best of the greedy roadmaps built by value density, by critical path and in an order shuffled by the
+// generator
+Roadmap greedyStartingRoadmap(shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, mt19937& generator) {
+	Roadmap roadmap = greedyInsertStories(Roadmap(instance, sprintData), ValueDensity);
+	Roadmap criticalPathRoadmap = greedyInsertStories(Roadmap(instance, sprintData), CriticalPath);
+	Roadmap shuffledRoadmap = randomRoadmap(instance, sprintData, generator);
+
+	if (criticalPathRoadmap.calculateValue() > roadmap.calculateValue())
+		roadmap = criticalPathRoadmap;
+
+	if (shuffledRoadmap.calculateValue() > roadmap.calculateValue())
+		roadmap = shuffledRoadmap;
+
+	return roadmap;
+}
+
+// Writes the sprint number of each story (-1 for the product backlog), followed by what each sprint delivers, in a
+// file that --previous can read back: JSON if the file name ends in .json and CSV otherwise (where the sprint totals
+// are a second table after the roadmap, starting with its own header row)
+bool writeRoadmapFile(const string& fileName, Roadmap& roadmap) {
+	ofstream roadmapFile(fileName, ios::trunc | ios::binary);
+
+	if (!roadmapFile.is_open())
+		return false;
+
+	bool json = fileName.size() >= 5 && fileName.compare(fileName.size() - 5, 5, ".json") == 0;
+
+	// Totals of each sprint position
+	vector<long long> storiesDelivered(roadmap.sprints.size(), 0);
+	vector<long long> pointsDelivered(roadmap.sprints.size(), 0);
+	vector<long long> valueDelivered(roadmap.sprints.size(), 0);
+
+	for (int storyNumber = 0; storyNumber < roadmap.numberOfStories(); ++storyNumber) {
+		int position = roadmap.storySprint[storyNumber];
+
+		if (position != -1) {
+			++storiesDelivered[position];
+			pointsDelivered[position] += roadmap.instance->storyPoints[storyNumber];
+			valueDelivered[position] += roadmap.instance->businessValue[storyNumber];
+		}
+	}
+
+	{
+		BufferedWriter output(roadmapFile);
+
+		if (json)
+			output << "{\n\t\"value\": " << roadmap.calculateValue() << ",\n\t\"sprints\": [";
+		else
+			output << "Story,Sprint\n";
+
+		for (int storyNumber = 0; !json && storyNumber < roadmap.numberOfStories(); ++storyNumber)
+			output << storyNumber << ',' << (roadmap.isAssigned(storyNumber) ? roadmap.assignedSprint(storyNumber).sprintNumber : -1) << '\n';
+
+		if (!json)
+			output << "Sprint,Capacity,Bonus,Stories,Story Points,Value,Weighted Value\n";
+
+		for (int i = 0; i < roadmap.sprints.size(); ++i) {
+			Sprint& sprint = roadmap.sprints[i];
+
+			if (json) {
+				output << (i == 0 ? "\n\t\t" : ",\n\t\t") << "{\"sprint\": " << sprint.sprintNumber << ", \"capacity\": " << sprint.sprintCapacity
+					<< ", \"bonus\": " << sprint.sprintBonus << ", \"stories\": " << storiesDelivered[i] << ", \"story_points\": " << pointsDelivered[i]
+					<< ", \"value\": " << valueDelivered[i] << ", \"weighted_value\": " << valueDelivered[i] * sprint.sprintBonus << "}";
+			}
+			else {
+				output << sprint.sprintNumber << ',' << sprint.sprintCapacity << ',' << sprint.sprintBonus << ',' << storiesDelivered[i] << ','
+					<< pointsDelivered[i] << ',' << valueDelivered[i] << ',' << valueDelivered[i] * sprint.sprintBonus << '\n';
+			}
+		}
+
+		if (json) {
+			output << "\n\t],\n\t\"story_sprints\": [";
+
+			for (int storyNumber = 0; storyNumber < roadmap.numberOfStories(); ++storyNumber)
+				output << (storyNumber == 0 ? "" : ", ") << (roadmap.isAssigned(storyNumber) ? roadmap.assignedSprint(storyNumber).sprintNumber : -1);
+
+			output << "]\n}\n";
+		}
+	}
+
+	roadmapFile.close();
+
+	return !roadmapFile.fail();
+}
+
+// Reads the story_sprints array of a JSON roadmap file written by writeRoadmapFile (stories from numberOfStories on
+// are skipped)
+bool loadRoadmapJson(const string& fileName, const char* data, size_t size, int numberOfStories, vector<int>& storySprintNumbers, string& error) {
+	const char* end = data + size;
+	const char key[] = "\"story_sprints\"";
+	const char* cursor = search(data, end, key, key + strlen(key));
+
+	if (cursor != end)
+		cursor = find(cursor, end, '[');
+
+	if (cursor == end) {
+		error = fileName + ": no story_sprints array";
+		return false;
+	}
+
+	storySprintNumbers.assign(numberOfStories, -1);
+	int storyNumber = 0;
+	++cursor;
+
+	while (true) {
+		while (cursor < end && (*cursor == ' ' || *cursor == ',' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n'))
+			++cursor;
+
+		if (cursor < end && *cursor == ']')
+			return true;
+
+		int sprintNumber;
+		from_chars_result result = from_chars(cursor, end, sprintNumber);
+
+		if (result.ec != errc() || sprintNumber < -1) {
+			error = fileName + ": story " + to_string(storyNumber) + " doesn't have a sprint number";
+			return false;
+		}
+
+		if (storyNumber < numberOfStories)
+			storySprintNumbers[storyNumber] = sprintNumber;
+
+		++storyNumber;
+		cursor = result.ptr;
+	}
+}
+
+// Reads a roadmap file written by writeRoadmapFile into the sprint number of each of the numberOfStories stories
+// (-1 for stories in the product backlog or not in the file), returns false with a description of any problem
+// Stories from numberOfStories on have left the backlog since the roadmap was written, so they are skipped
+// CSV files end at the header of the sprint totals table, if there is one
+bool loadRoadmapFile(const string& fileName, int numberOfStories, vector<int>& storySprintNumbers, string& error) {
+	MappedFile file(fileName);
+
+	if (!file.isOpen()) {
+		error = "Cannot open roadmap file " + fileName;
+		return false;
+	}
+
+	const char* firstCharacter = file.data;
+
+	while (firstCharacter < file.data + file.size && isspace((unsigned char)*firstCharacter))
+		++firstCharacter;
+
+	if (firstCharacter < file.data + file.size && *firstCharacter == '{')
+		return loadRoadmapJson(fileName, file.data, file.size, numberOfStories, storySprintNumbers, error);
+
+	CsvReader reader(file.data, file.size);
+	reader.nextRow(); // Skip column headers
+
+	storySprintNumbers.assign(numberOfStories, -1);
+
+	while (reader.nextRow()) {
+		const char* fieldStart;
+		const char* fieldEnd;
+		int storyNumber, sprintNumber;
+
+		reader.nextField(fieldStart, fieldEnd);
+
+		if (string(fieldStart, fieldEnd) == "Sprint")
+			break;
+
+		if (!parseInt(fieldStart, fieldEnd, storyNumber) || storyNumber < 0) {
+			error = reader.location(fileName) + ": '" + string(fieldStart, fieldEnd) + "' is not a story number";
+			return false;
+		}
+
+		if (!reader.hasField()) {
+			error = reader.location(fileName) + ": missing sprint number";
+			return false;
+		}
+
+		reader.nextField(fieldStart, fieldEnd);
+
+		if (!parseInt(fieldStart, fieldEnd, sprintNumber) || sprintNumber < -1) {
+			error = reader.location(fileName) + ": '" + string(fieldStart, fieldEnd) + "' is not a sprint number";
+			return false;
+		}
+
+		if (storyNumber < numberOfStories)
+			storySprintNumbers[storyNumber] = sprintNumber;
+	}
+
+	return true;
+}
+
+// Turns a previous roadmap into a feasible roadmap for the current data: stories keep their previous sprint where
+// that is still valid (in dependency order), the rest are greedily inserted by business value per story point, and
+// then stories are moved into any valid sprint with a higher bonus
+// The first frozenSprints sprints are committed: they keep whichever of their previous stories are still valid and
+// nothing else is added to them or moved out of them
+Roadmap repairRoadmap(shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, const vector<int>& previousSprintNumbers, int frozenSprints, int& storiesKept) {
+	Roadmap roadmap(instance, sprintData);
+	vector<bool> frozen(sprintData.size());
+
+	for (int i = 0; i < sprintData.size(); ++i)
+		frozen[i] = sprintData[i].sprintNumber != -1 && sprintData[i].sprintNumber < frozenSprints;
+
+	auto isFrozen = [&](int sprintPosition) {
+		return sprintPosition != -1 && frozen[sprintPosition];
+	};
+
+	storiesKept = 0;
+
+	for (int storyNumber : roadmap.instance->topologicalOrder()) {
+		int previousSprintNumber = storyNumber < previousSprintNumbers.size() ? previousSprintNumbers[storyNumber] : -1;
+
+		// Stories that were in the product backlog get another chance in the greedy pass
+		if (previousSprintNumber == -1 || previousSprintNumber + 1 >= roadmap.sprintPositions.size() || roadmap.sprintPositions[previousSprintNumber + 1] == -1)
+			continue;
+
+		Sprint& previousSprint = roadmap.sprints[roadmap.sprintPositions[previousSprintNumber + 1]];
+
+		if (roadmap.validInsert(storyNumber, previousSprint)) {
+			roadmap.addStoryToSprint(storyNumber, previousSprint);
+			++storiesKept;
+		}
+	}
+
+	vector<int> unplacedStories;
+
+	for (int storyNumber = 0; storyNumber < roadmap.numberOfStories(); ++storyNumber) {
+		if (!roadmap.isAssigned(storyNumber))
+			unplacedStories.push_back(storyNumber);
+	}
+
+	roadmap = greedyInsertStories(unplacedStories, move(roadmap), ValueDensity, frozen);
+
+	// Local repair: pull stories forward into sprints with a higher bonus while they stay valid
+	bool improved = true;
+
+	for (int pass = 0; improved && pass < 10; ++pass) {
+		improved = false;
+
+		for (int storyNumber : roadmap.instance->topologicalOrder()) {
+			if (isFrozen(roadmap.storySprint[storyNumber]))
+				continue;
+
+			Sprint& from = roadmap.assignedSprint(storyNumber);
+			int bestPosition = -1;
+			int bestBonus = from.sprintNumber == -1 ? 0 : from.sprintBonus;
+
+			for (int i = 0; i < roadmap.sprints.size(); ++i) {
+				Sprint& to = roadmap.sprints[i];
+
+				if (to.sprintNumber != -1 && !isFrozen(i) && to.sprintBonus > bestBonus && roadmap.validInsert(storyNumber, to)) {
+					bestPosition = i;
+					bestBonus = to.sprintBonus;
+				}
+			}
+
+			if (bestPosition != -1) {
+				roadmap.moveStory(storyNumber, roadmap.sprints[bestPosition]);
+				improved = true;
+			}
+		}
+	}
+
+	return roadmap;
+}
+
+// Ruin-and-recreate large neighbourhood search with a simulated annealing acceptance rule
+// Each iteration removes a group of stories linked by dependencies (plus some stories from the product backlog),
+// greedily re-inserts them by business value per story point, and keeps the result if it is accepted
+class LargeNeighbourhoodSearch {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	vector<Sprint> sprintData; // All sprints, including the product backlog
+
+	double timeLimit; // Seconds
+	long long targetValue = LLONG_MAX; // Stops early once the best roadmap is worth this much
+	mt19937 generator;
+
+	int maximumRuinSize;
+	int backlogPosition = -1; // Position of the product backlog in sprintData
+	vector<int> sprintOrder; // Positions of the real sprints, by bonus (highest first)
+
+	long long iterations = 0;
+	vector<pair<double, long long>> progress; // (milliseconds, value) every time the best roadmap improves
+
+	// Scratch space reused by every iteration
+	vector<int> removedStories;
+	vector<int> originalSprint; // Sprint position of each removed story before the iteration
+	vector<long long> removedInIteration;
+	vector<int> storiesToInsert;
+	vector<double> density; // Perturbed density of each story being re-inserted (only theirs are kept up to date)
+
+	LargeNeighbourhoodSearch(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprintData, double timeLimit, unsigned int seed) {
+		this->instance = instance;
+		this->sprintData = sprintData;
+		this->timeLimit = timeLimit;
+		this->generator.seed(seed);
+
+		maximumRuinSize = min(instance->numberOfStories(), 40);
+		removedInIteration.assign(instance->numberOfStories(), -1);
+		density.assign(instance->numberOfStories(), 0);
+
+		for (int i = 0; i < this->sprintData.size(); ++i) {
+			if (this->sprintData[i].sprintNumber == -1)
+				backlogPosition = i;
+			else
+				sprintOrder.push_back(i);
+		}
+
+		stable_sort(sprintOrder.begin(), sprintOrder.end(), [&](int a, int b) {
+			return this->sprintData[a].sprintBonus > this->sprintData[b].sprintBonus;
+		});
+	}
+
+	void removeStory(Roadmap& roadmap, int storyNumber) {
+		if (removedInIteration[storyNumber] == iterations)
+			return;
+
+		removedInIteration[storyNumber] = iterations;
+		removedStories.push_back(storyNumber);
+		originalSprint.push_back(roadmap.storySprint[storyNumber]);
+
+		if (roadmap.isAssigned(storyNumber))
+			roadmap.removeStoryFromSprint(storyNumber);
+	}
+
+	// Removes a chain of stories linked by dependencies, starting from a random story delivered in a sprint
+	void ruin(Roadmap& roadmap) {
+		const PlanningInstance& stories = *instance;
+		removedStories.clear();
+		originalSprint.clear();
+
+		int ruinSize = 1 + generator() % maximumRuinSize;
+		int seedStory = generator() % stories.numberOfStories();
+
+		// Prefer to start from a story that is delivered, so the iteration frees some capacity
+		for (int attempt = 0; attempt < 10 && roadmap.storySprint[seedStory] == backlogPosition; ++attempt)
+			seedStory = generator() % stories.numberOfStories();
+
+		vector<int> chain = { seedStory };
+
+		for (int position = 0; position < chain.size() && removedStories.size() < ruinSize; ++position) {
+			int storyNumber = chain[position];
+
+			if (removedInIteration[storyNumber] == iterations)
+				continue;
+
+			removeStory(roadmap, storyNumber);
+
+			for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d)
+				chain.push_back(stories.dependencies[d]);
+
+			for (int d = stories.dependeeOffsets[storyNumber]; d < stories.dependeeOffsets[storyNumber + 1]; ++d)
+				chain.push_back(stories.dependees[d]);
+
+			// Also free up some of the sprint the chain passes through
+			if (originalSprint.back() != backlogPosition && originalSprint.back() != -1) {
+				vector<int>& sprintStories = roadmap.sprintStories[originalSprint.back()];
+
+				if (!sprintStories.empty())
+					chain.push_back(sprintStories[generator() % sprintStories.size()]);
+			}
+		}
+
+		// Dependees of removed stories can't stay in their sprints, so remove them too
+		for (int position = 0; position < removedStories.size(); ++position) {
+			int removedStory = removedStories[position];
+
+			for (int d = stories.dependeeOffsets[removedStory]; d < stories.dependeeOffsets[removedStory + 1]; ++d) {
+				int dependeeNumber = stories.dependees[d];
+				int dependeeSprint = roadmap.storySprint[dependeeNumber];
+
+				if (dependeeSprint != -1 && dependeeSprint != backlogPosition)
+					removeStory(roadmap, dependeeNumber);
+			}
+		}
+
+		// Give some stories from the product backlog a chance to be delivered
+		if (backlogPosition != -1) {
+			vector<int>& backlogStories = roadmap.sprintStories[backlogPosition];
+
+			for (int i = 0; i < ruinSize && !backlogStories.empty(); ++i)
+				removeStory(roadmap, backlogStories[generator() % backlogStories.size()]);
+		}
+	}
+
+	// Greedily inserts the removed stories into their most valuable valid sprints, densest stories first
+	// The densities are perturbed slightly and sprints are occasionally skipped, so that re-inserting the same
+	// stories doesn't always rebuild the same roadmap
+	void recreate(Roadmap& roadmap) {
+		const PlanningInstance& stories = *instance;
+		storiesToInsert = removedStories;
+		uniform_real_distribution<double> noise(0.8, 1.2);
+
+		for (int storyNumber : storiesToInsert)
+			density[storyNumber] = (stories.businessValue[storyNumber] + 1.0) / (stories.storyPoints[storyNumber] + 1.0) * noise(generator);
+
+		sort(storiesToInsert.begin(), storiesToInsert.end(), [&](int a, int b) {
+			return density[a] > density[b];
+		});
+
+		// A story can only be inserted once its dependencies are, so keep passing over the stories until nothing changes
+		bool inserted = true;
+
+		while (inserted) {
+			inserted = false;
+
+			for (int storyNumber : storiesToInsert) {
+				if (roadmap.isAssigned(storyNumber))
+					continue;
+
+				for (int sprintPosition : sprintOrder) {
+					if (generator() % 10 == 0)
+						continue;
+
+					if (roadmap.validInsert(storyNumber, sprintData[sprintPosition])) {
+						roadmap.addStoryToSprint(storyNumber, sprintData[sprintPosition]);
+						inserted = true;
+						break;
+					}
+				}
+			}
+		}
+
+		// Anything left over goes back to the product backlog
+		for (int storyNumber : storiesToInsert) {
+			if (!roadmap.isAssigned(storyNumber) && backlogPosition != -1)
+				roadmap.addStoryToSprint(storyNumber, sprintData[backlogPosition]);
+		}
+	}
+
+	// Puts every story touched by the iteration back where it was
+	void undo(Roadmap& roadmap) {
+		for (int storyNumber : removedStories) {
+			if (roadmap.isAssigned(storyNumber))
+				roadmap.removeStoryFromSprint(storyNumber);
+		}
+
+		for (int i = 0; i < removedStories.size(); ++i) {
+			if (originalSprint[i] != -1)
+				roadmap.addStoryToSprint(removedStories[i], sprintData[originalSprint[i]]);
+		}
+	}
+
+	// Improves the given feasible roadmap until the time limit is reached
+	Roadmap solve(Roadmap roadmap) {
+		auto startTime = chrono::steady_clock::now();
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+
+		vector<int> bestAssignment = roadmap.storySprint;
+		long long bestValue = roadmap.calculateValue();
+		long long currentValue = bestValue;
+
+		progress.push_back(make_pair(0.0, bestValue));
+
+		// Start hot enough to often accept losing a tenth of an average story in the best sprint, and cool linearly to zero
+		double startingTemperature = 0;
+
+		if (numberOfStories > 0 && !sprintOrder.empty()) {
+			for (int businessValue : stories.businessValue)
+				startingTemperature += businessValue;
+
+			startingTemperature = 0.1 * startingTemperature / numberOfStories * sprintData[sprintOrder[0]].sprintBonus;
+		}
+
+		uniform_real_distribution<double> uniform(0, 1);
+
+		while (numberOfStories > 0 && bestValue < targetValue) {
+			double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+			if (elapsed >= timeLimit)
+				break;
+
+			double temperature = startingTemperature * (1 - elapsed / timeLimit);
+
+			ruin(roadmap);
+			recreate(roadmap);
+
+			long long newValue = roadmap.calculateValue();
+
+			if (newValue >= currentValue || (temperature > 0 && uniform(generator) < exp((newValue - currentValue) / temperature))) {
+				currentValue = newValue;
+
+				if (newValue > bestValue) {
+					bestValue = newValue;
+					bestAssignment = roadmap.storySprint;
+					progress.push_back(make_pair(elapsed * 1000, bestValue));
+				}
+			}
+			else {
+				undo(roadmap);
+			}
+
+			++iterations;
+		}
+
+		Roadmap bestRoadmap(instance, sprintData);
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+			if (bestAssignment[storyNumber] != -1)
+				bestRoadmap.addStoryToSprint(storyNumber, sprintData[bestAssignment[storyNumber]]);
+		}
+
+		return bestRoadmap;
+	}
+};
+
+// Runs many randomized greedy constructions on parallel worker threads and keeps the best few roadmaps
+// Each worker has its own random number generator and Roadmap, so the only shared state in the hot loop is the
+// restart counter and the best value found so far (both atomics)
+class RestartPortfolio {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	vector<Sprint> sprintData; // All sprints, including the product backlog
+
+	int numberOfRestarts;
+	int numberOfThreads;
+	int solutionsToKeep;
+	double timeLimit; // Seconds (0 means no limit)
+	unsigned long long seed;
+	long long targetValue = LLONG_MAX; // Stops early once a roadmap worth this much is found
+
+	atomic<int> restartsStarted; // Restarts claimed by the workers (some are claimed after the limits are reached)
+	atomic<int> restartsRun;
+	atomic<long long> bestValue;
+
+	mutex bestRoadmapMutex;
+	vector<int> bestAssignment; // Sprint position of each story in the best roadmap
+
+	vector<vector<pair<long long, vector<int>>>> threadSolutions; // Each worker's best (value, sprint positions) roadmaps
+	vector<pair<long long, vector<int>>> bestSolutions; // The best roadmaps across all workers, best first
+
+	RestartPortfolio(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprintData, int numberOfRestarts, int numberOfThreads, int solutionsToKeep, double timeLimit, unsigned long long seed) {
+		this->instance = instance;
+		this->sprintData = sprintData;
+		this->numberOfRestarts = numberOfRestarts;
+		this->numberOfThreads = max(1, numberOfThreads);
+		this->solutionsToKeep = max(1, solutionsToKeep);
+		this->timeLimit = timeLimit;
+		this->seed = seed;
+	}
+
+	// Adds a roadmap to a list of the best roadmaps (best first), unless it is already there or not good enough
+	void keepSolution(vector<pair<long long, vector<int>>>& solutions, long long value, const vector<int>& assignment) {
+		if (solutions.size() == solutionsToKeep && value <= solutions.back().first)
+			return;
+
+		for (pair<long long, vector<int>>& solution : solutions) {
+			if (solution.first == value && solution.second == assignment)
+				return;
+		}
+
+		if (solutions.size() == solutionsToKeep)
+			solutions.pop_back();
+
+		auto position = solutions.begin();
+
+		while (position != solutions.end() && position->first >= value)
+			++position;
+
+		solutions.insert(position, make_pair(value, assignment));
+	}
+
+	void worker(int threadNumber, chrono::steady_clock::time_point startTime) {
+		mt19937_64 generator(seed + 0x9E3779B97F4A7C15ULL * (threadNumber + 1));
+		uniform_real_distribution<double> noise(0.5, 1.5);
+
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+		Roadmap roadmap(instance, sprintData);
+
+		vector<int> storyNumbers;
+		vector<double> priority(numberOfStories);
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber)
+			storyNumbers.push_back(storyNumber);
+
+		while (restartsStarted.fetch_add(1) < numberOfRestarts) {
+			if (timeLimit > 0 && chrono::duration<double>(chrono::steady_clock::now() - startTime).count() > timeLimit)
+				break;
+
+			if (bestValue.load() >= targetValue)
+				break;
+
+			// Pick a priority rule at random for this restart and perturb it
+			int rule = generator() % 4;
+
+			for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+				double randomFactor = noise(generator);
+
+				if (rule == 0)
+					priority[storyNumber] = randomFactor;
+				else if (rule == 1)
+					priority[storyNumber] = randomFactor * (stories.businessValue[storyNumber] + 1.0) / (stories.storyPoints[storyNumber] + 1.0);
+				else if (rule == 2)
+					priority[storyNumber] = randomFactor * stories.businessValue[storyNumber];
+				else
+					priority[storyNumber] = randomFactor * (stories.dependeeOffsets[storyNumber + 1] - stories.dependeeOffsets[storyNumber] + 1);
+			}
+
+			// Start from an empty roadmap
+			for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+				if (roadmap.isAssigned(storyNumber))
+					roadmap.removeStoryFromSprint(storyNumber);
+			}
+
+			insertStoriesByPriority(storyNumbers, roadmap, priority);
+			++restartsRun;
+
+			long long value = roadmap.calculateValue();
+
+			keepSolution(threadSolutions[threadNumber], value, roadmap.storySprint);
+
+			// Publish a new best roadmap (the lock is only taken after winning the race on the atomic)
+			long long currentBest = bestValue.load();
+
+			while (value > currentBest && !bestValue.compare_exchange_weak(currentBest, value));
+
+			if (value > currentBest) {
+				lock_guard<mutex> lock(bestRoadmapMutex);
+
+				if (value == bestValue.load())
+					bestAssignment = roadmap.storySprint;
+			}
+		}
+	}
+
+	// Runs the restarts and returns the best roadmap found
+	Roadmap run() {
+		restartsStarted = 0;
+		restartsRun = 0;
+		bestValue = -1;
+		threadSolutions.assign(numberOfThreads, vector<pair<long long, vector<int>>>());
+
+		auto startTime = chrono::steady_clock::now();
+		vector<thread> workers;
+
+		for (int threadNumber = 0; threadNumber < numberOfThreads; ++threadNumber)
+			workers.push_back(thread(&RestartPortfolio::worker, this, threadNumber, startTime));
+
+		for (thread& worker : workers)
+			worker.join();
+
+		bestSolutions.clear();
+
+		for (vector<pair<long long, vector<int>>>& solutions : threadSolutions) {
+			for (pair<long long, vector<int>>& solution : solutions)
+				keepSolution(bestSolutions, solution.first, solution.second);
+		}
+
+		Roadmap roadmap(instance, sprintData);
+
+		for (int storyNumber = 0; storyNumber < bestAssignment.size(); ++storyNumber) {
+			if (bestAssignment[storyNumber] != -1)
+				roadmap.addStoryToSprint(storyNumber, sprintData[bestAssignment[storyNumber]]);
+		}
+
+		return roadmap;
+	}
+};
+
+// Fixed set of worker threads that run the tasks 0 to count - 1 of a job, so a job can be repeated many times (as
+// in each Lagrangian iteration) without starting new threads
+class ThreadPool {
+public:
+	vector<thread> workers;
+	mutex jobMutex;
+	condition_variable jobStarted;
+	condition_variable jobFinished;
+
+	function<void(long long)> task;
+	long long taskCount = 0;
+	atomic<long long> nextTask; // Each worker claims one past the end before it stops, so this has room beyond taskCount
+	int workersFinished = 0; // Workers done with the current job (every worker takes part in every job)
+	long long job = 0; // Incremented for each job, so workers know when there is a new one
+	bool stopping = false;
+
+	ThreadPool(int numberOfThreads) {
+		nextTask = 0;
+
+		// The calling thread also runs tasks, so one fewer worker is needed
+		for (int t = 1; t < numberOfThreads; ++t)
+			workers.push_back(thread([this]() { work(); }));
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool() {
+		{
+			lock_guard<mutex> lock(jobMutex);
+			stopping = true;
+		}
+
+		jobStarted.notify_all();
+
+		for (thread& worker : workers)
+			worker.join();
+	}
+
+	void runTasks() {
+		for (long long t = nextTask++; t < taskCount; t = nextTask++)
+			task(t);
+	}
+
+	void work() {
+		long long jobsSeen = 0;
+
+		while (true) {
+			{
+				unique_lock<mutex> lock(jobMutex);
+				jobStarted.wait(lock, [&]() { return stopping || job != jobsSeen; });
+
+				if (stopping)
+					return;
+
+				jobsSeen = job;
+			}
+
+			runTasks();
+
+			{
+				lock_guard<mutex> lock(jobMutex);
+				++workersFinished;
+			}
+
+			jobFinished.notify_all();
+		}
+	}
+
+	// Runs task(0) to task(count - 1) across the pool and waits for all of them to finish
+	void run(long long count, function<void(long long)> task) {
+		{
+			lock_guard<mutex> lock(jobMutex);
+			this->task = task;
+			this->taskCount = count;
+			nextTask = 0;
+			workersFinished = 0;
+			++job;
+		}
+
+		jobStarted.notify_all();
+		runTasks();
+
+		unique_lock<mutex> lock(jobMutex);
+		jobFinished.wait(lock, [&]() { return workersFinished == workers.size(); });
+	}
+};
+
+// Maximum weight closure of a graph (a set of nodes with no edges leaving it and the highest total weight), found
+// as a minimum cut with Dinic's algorithm
+// Weights are reset between solves, but the edges are kept
+class MaximumClosure {
+public:
+	class Edge {
+	public:
+		int to;
+		double capacity;
+	};
+
+	const double INFINITE_CAPACITY = 1e18;
+	const double EPSILON = 1e-9;
+
+	int numberOfNodes;
+	int source, sink;
+
+	vector<Edge> edges; // Each edge is followed by its reverse edge
+	vector<vector<int>> adjacency;
+	vector<int> level;
+	vector<int> nextEdge;
+
+	vector<int> weightEdges; // Index of each node's source edge (its sink edge follows the reverse source edge)
+	vector<char> forcedOut; // Nodes that can never be in the closure
+	vector<int> closureEdges;
+
+	MaximumClosure(int numberOfNodes) {
+		this->numberOfNodes = numberOfNodes;
+		this->source = numberOfNodes;
+		this->sink = numberOfNodes + 1;
+
+		adjacency.resize(numberOfNodes + 2);
+		forcedOut.assign(numberOfNodes, false);
+
+		for (int node = 0; node < numberOfNodes; ++node) {
+			weightEdges.push_back(edges.size());
+			addEdge(source, node);
+			addEdge(node, sink);
+		}
+	}
+
+	void addEdge(int from, int to) {
+		adjacency[from].push_back(edges.size());
+		edges.push_back({ to, 0 });
+		adjacency[to].push_back(edges.size());
+		edges.push_back({ from, 0 });
+	}
+
+	// If from is in the closure, to must be too
+	void addRequirement(int from, int to) {
+		closureEdges.push_back(edges.size());
+		addEdge(from, to);
+	}
+
+	bool buildLevels() {
+		level.assign(numberOfNodes + 2, -1);
+		level[source] = 0;
+
+		vector<int> queue = { source };
+
+		for (int position = 0; position < queue.size(); ++position) {
+			int node = queue[position];
+
+			for (int e : adjacency[node]) {
+				if (edges[e].capacity > EPSILON && level[edges[e].to] == -1) {
+					level[edges[e].to] = level[node] + 1;
+					queue.push_back(edges[e].to);
+				}
+			}
+		}
+
+		return level[sink] != -1;
+	}
+
+	// Pushes flow along shortest augmenting paths until the level graph is blocked (iteratively, as paths can be
+	// as long as the graph)
+	void blockingFlow() {
+		nextEdge.assign(numberOfNodes + 2, 0);
+
+		vector<int> path;
+		int node = source;
+
+		while (true) {
+			if (node == sink) {
+				double flow = INFINITE_CAPACITY;
+
+				for (int e : path)
+					flow = min(flow, edges[e].capacity);
+
+				for (int e : path) {
+					edges[e].capacity -= flow;
+					edges[e ^ 1].capacity += flow;
+				}
+
+				path.clear();
+				node = source;
+				continue;
+			}
+
+			bool advanced = false;
+
+			for (; nextEdge[node] < adjacency[node].size(); ++nextEdge[node]) {
+				Edge& edge = edges[adjacency[node][nextEdge[node]]];
+
+				if (edge.capacity > EPSILON && level[edge.to] == level[node] + 1) {
+					path.push_back(adjacency[node][nextEdge[node]]);
+					node = edge.to;
+					advanced = true;
+					break;
+				}
+			}
+
+			if (!advanced) {
+				if (node == source)
+					return;
+
+				// Dead end, so retreat and never come back here in this phase
+				level[node] = -1;
+				int e = path.back();
+				path.pop_back();
+				node = edges[e ^ 1].to;
+				++nextEdge[node];
+			}
+		}
+	}
+
+	// Returns which nodes are in the maximum weight closure for the given node weights
+	vector<char> solve(const vector<double>& weights) {
+		for (Edge& edge : edges)
+			edge.capacity = 0;
+
+		for (int e : closureEdges)
+			edges[e].capacity = INFINITE_CAPACITY;
+
+		for (int node = 0; node < numberOfNodes; ++node) {
+			int e = weightEdges[node];
+
+			edges[e].capacity = max(0.0, weights[node]);
+			edges[e + 2].capacity = forcedOut[node] ? INFINITE_CAPACITY : max(0.0, -weights[node]);
+		}
+
+		while (buildLevels())
+			blockingFlow();
+
+		// The closure is whatever the source can still reach
+		buildLevels();
+
+		vector<char> inClosure(numberOfNodes);
+
+		for (int node = 0; node < numberOfNodes; ++node)
+			inClosure[node] = level[node] != -1;
+
+		return inClosure;
+	}
+};
+
+// Splits the backlog into the weakly connected components of its dependency graph, which only interact through the
+// sprint capacities, and coordinates them with a Lagrangian relaxation of the capacity rows
+// For multipliers lambda (one per sprint), taking story j in sprint s is worth value(j) * bonus(s) - lambda(s) *
+// points(j), each component can then be solved on its own and exactly (a maximum weight closure over "story j is done
+// by sprint s" nodes), and the total plus the sum of lambda(s) * capacity(s) is an upper bound. The multipliers are
+// improved by subgradient steps, with the components of each step solved in parallel, and the Lagrangian roadmaps
+// are repaired into feasible roadmaps for the lower bound
+class ComponentDecomposition {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	vector<Sprint> sprintData; // All sprints, including the product backlog (sprint positions match sprint numbers)
+
+	int numberOfSprints; // Real sprints
+	int numberOfThreads;
+	int maximumIterations;
+	double timeLimit; // Seconds (0 means no limit)
+
+	vector<vector<int>> components; // Story numbers of each component, largest first
+	vector<MaximumClosure> closures; // Subproblem of each component with more than one story
+
+	double upperBound = 0;
+	int iterations = 0;
+
+	ComponentDecomposition(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprintData, int numberOfThreads, int maximumIterations, double timeLimit) {
+		this->instance = instance;
+		this->sprintData = sprintData;
+		this->numberOfThreads = max(1, numberOfThreads);
+		this->maximumIterations = maximumIterations;
+		this->timeLimit = timeLimit;
+
+		numberOfSprints = 0;
+
+		for (Sprint& sprint : sprintData) {
+			if (sprint.sprintNumber != -1)
+				++numberOfSprints;
+		}
+
+		findComponents();
+
+		// Components are largest first, so the components with more than one story have the same numbers as their
+		// closures
+		for (vector<int>& component : components) {
+			if (component.size() > 1)
+				closures.push_back(buildClosure(component));
+		}
+	}
+
+	// Union-find over the dependencies
+	void findComponents() {
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+		vector<int> parent(numberOfStories);
+
+		for (int j = 0; j < numberOfStories; ++j)
+			parent[j] = j;
+
+		function<int(int)> root = [&](int j) {
+			while (parent[j] != j) {
+				parent[j] = parent[parent[j]];
+				j = parent[j];
+			}
+
+			return j;
+		};
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			for (int d = stories.dependencyOffsets[j]; d < stories.dependencyOffsets[j + 1]; ++d)
+				parent[root(j)] = root(stories.dependencies[d]);
+		}
+
+		map<int, int> componentOfRoot;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			int componentRoot = root(j);
+
+			if (componentOfRoot.count(componentRoot) == 0) {
+				componentOfRoot[componentRoot] = components.size();
+				components.push_back(vector<int>());
+			}
+
+			components[componentOfRoot[componentRoot]].push_back(j);
+		}
+
+		stable_sort(components.begin(), components.end(), [](const vector<int>& a, const vector<int>& b) {
+			return a.size() > b.size();
+		});
+	}
+
+	// Node k * sprints + s means the k-th story of the component is done by sprint s
+	MaximumClosure buildClosure(vector<int>& component) {
+		const PlanningInstance& stories = *instance;
+		MaximumClosure closure(component.size() * numberOfSprints);
+		map<int, int> positionInComponent;
+
+		for (int k = 0; k < component.size(); ++k)
+			positionInComponent[component[k]] = k;
+
+		for (int k = 0; k < component.size(); ++k) {
+			int storyNumber = component[k];
+			bool hasDependencies = stories.dependencyOffsets[storyNumber] < stories.dependencyOffsets[storyNumber + 1];
+
+			for (int s = 0; s < numberOfSprints; ++s) {
+				int node = k * numberOfSprints + s;
+
+				// Done by sprint s means done by every later sprint too
+				if (s + 1 < numberOfSprints)
+					closure.addRequirement(node, node + 1);
+
+				// Each dependency must be done by the sprint before
+				if (hasDependencies && s == 0)
+					closure.forcedOut[node] = true;
+
+				for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d) {
+					if (s > 0)
+						closure.addRequirement(node, positionInComponent[stories.dependencies[d]] * numberOfSprints + s - 1);
+				}
+			}
+		}
+
+		return closure;
+	}
+
+	double reducedValue(int storyNumber, int s, const vector<double>& multipliers) {
+		return (double)instance->businessValue[storyNumber] * sprintData[s].sprintBonus - multipliers[s] * instance->storyPoints[storyNumber];
+	}
+
+	// Best sprint of each story of the component for the multipliers (-1 for the product backlog), returns the
+	// component's Lagrangian value
+	double solveComponent(int c, const vector<double>& multipliers, vector<int>& storySprint) {
+		vector<int>& component = components[c];
+
+		if (component.size() == 1) {
+			int storyNumber = component[0];
+			bool hasDependencies = instance->dependencyOffsets[storyNumber] < instance->dependencyOffsets[storyNumber + 1];
+			double bestValue = 0;
+			storySprint[storyNumber] = -1;
+
+			for (int s = 0; s < numberOfSprints && !hasDependencies; ++s) {
+				if (reducedValue(storyNumber, s, multipliers) > bestValue) {
+					bestValue = reducedValue(storyNumber, s, multipliers);
+					storySprint[storyNumber] = s;
+				}
+			}
+
+			return bestValue;
+		}
+
+		// Taking story j in sprint s is y(j, s) - y(j, s - 1), so node (j, s) is weighted with the value of sprint s
+		// minus the value of sprint s + 1
+		vector<double> weights(component.size() * numberOfSprints);
+
+		for (int k = 0; k < component.size(); ++k) {
+			for (int s = 0; s < numberOfSprints; ++s) {
+				double nextValue = s + 1 < numberOfSprints ? reducedValue(component[k], s + 1, multipliers) : 0;
+				weights[k * numberOfSprints + s] = reducedValue(component[k], s, multipliers) - nextValue;
+			}
+		}
+
+		vector<char> inClosure = closures[c].solve(weights);
+		double value = 0;
+
+		for (int k = 0; k < component.size(); ++k) {
+			int sprint = -1;
+
+			for (int s = numberOfSprints - 1; s >= 0 && inClosure[k * numberOfSprints + s]; --s)
+				sprint = s;
+
+			storySprint[component[k]] = sprint;
+
+			if (sprint != -1)
+				value += reducedValue(component[k], sprint, multipliers);
+		}
+
+		return value;
+	}
+
+	Roadmap solve(Roadmap incumbent) {
+		auto startTime = chrono::steady_clock::now();
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+
+		// The transport bound is also valid, and can be tighter in early iterations
+		upperBound = BranchAndBoundSolver(instance, sprintData, 0).upperBound();
+
+		// Start with each sprint's capacity priced at its bonus times the average value per story point
+		long long totalValue = 0, totalPoints = 0;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			totalValue += stories.businessValue[j];
+			totalPoints += stories.storyPoints[j];
+		}
+
+		double averageDensity = totalPoints > 0 ? (double)totalValue / totalPoints : 0;
+		vector<double> multipliers(numberOfSprints);
+
+		for (int s = 0; s < numberOfSprints; ++s)
+			multipliers[s] = sprintData[s].sprintBonus * averageDensity;
+
+		ThreadPool pool(numberOfThreads);
+		vector<int> storySprint(numberOfStories, -1);
+		vector<double> componentValues(components.size());
+
+		double stepScale = 2;
+		int iterationsWithoutImprovement = 0;
+
+		for (iterations = 0; iterations < maximumIterations; ++iterations) {
+			if (timeLimit > 0 && chrono::duration<double>(chrono::steady_clock::now() - startTime).count() > timeLimit)
+				break;
+
+			pool.run(components.size(), [&](int c) {
+				componentValues[c] = solveComponent(c, multipliers, storySprint);
+			});
+
+			double lagrangianValue = 0;
+
+			for (double componentValue : componentValues)
+				lagrangianValue += componentValue;
+
+			vector<long long> load(numberOfSprints, 0);
+
+			for (int j = 0; j < numberOfStories; ++j) {
+				if (storySprint[j] != -1)
+					load[storySprint[j]] += stories.storyPoints[j];
+			}
+
+			double squaredNorm = 0;
+			vector<double> subgradient(numberOfSprints);
+
+			for (int s = 0; s < numberOfSprints; ++s) {
+				lagrangianValue += multipliers[s] * sprintData[s].sprintCapacity;
+				subgradient[s] = sprintData[s].sprintCapacity - load[s];
+				squaredNorm += subgradient[s] * subgradient[s];
+			}
+
+			if (lagrangianValue < upperBound - 1e-9) {
+				upperBound = lagrangianValue;
+				iterationsWithoutImprovement = 0;
+			}
+			else if (++iterationsWithoutImprovement >= 5) {
+				stepScale /= 2;
+				iterationsWithoutImprovement = 0;
+			}
+
+			// Turn the Lagrangian roadmap into a feasible one every few iterations
+			if (iterations % 5 == 0) {
+				int storiesKept;
+				Roadmap repaired = repairRoadmap(instance, sprintData, storySprint, 0, storiesKept);
+
+				if (repaired.calculateValue() > incumbent.calculateValue())
+					incumbent = repaired;
+			}
+
+			// Stop once the capacities are respected exactly, or the bound meets the incumbent
+			if (squaredNorm == 0 || upperBound - incumbent.calculateValue() < 1 - 1e-9 || stepScale < 1e-4)
+				break;
+
+			// Polyak step towards the incumbent value
+			double step = stepScale * (lagrangianValue - incumbent.calculateValue()) / squaredNorm;
+
+			for (int s = 0; s < numberOfSprints; ++s)
+				multipliers[s] = max(0.0, multipliers[s] - step * subgradient[s]);
+		}
+
+		return incumbent;
+	}
+
+	int largestComponent() {
+		return components.empty() ? 0 : components[0].size();
+	}
+};
+
+// Phase timings and search progress of a run, written as JSON or CSV when the run ends so the time spent in each
+// phase (and how the search converged) can be charted
+class Telemetry {
+public:
+	string fileName; // "" means nothing is recorded to a file
+	string format; // json or csv
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+
+	string solver;
+	string status;
+	int numberOfStories = 0;
+	int numberOfSprints = 0;
+	double objective = NAN;
+
+	// Phases are kept in the order they finish, as (name, start, duration) in milliseconds since the start
+	vector<tuple<string, double, double>> phases;
+
+	// Search progress: milliseconds since the start, incumbent value, best bound, relative gap and nodes explored
+	// (NAN where the solver doesn't know the value)
+	class ProgressPoint {
+	public:
+		double milliseconds, incumbent, bound, gap;
+		long long nodes;
+	};
+
+	vector<ProgressPoint> progress;
+	mutex progressMutex; // CPLEX can call the informational callback from several threads
+
+	Telemetry(string fileName, string format) {
+		this->fileName = fileName;
+		this->format = format;
+	}
+
+	Telemetry(const Telemetry&) = delete;
+	Telemetry& operator=(const Telemetry&) = delete;
+
+	~Telemetry() {
+		if (fileName != "" && !write())
+			cout << "Cannot write telemetry file " << fileName << endl;
+	}
+
+	double elapsedMilliseconds() {
+		return chrono::duration<double, std::milli>(chrono::steady_clock::now() - startTime).count();
+	}
+
+	void addPhase(const string& name, double startMilliseconds, double milliseconds) {
+		phases.push_back(make_tuple(name, startMilliseconds, milliseconds));
+	}
+
+	// Records a progress point, skipping points that repeat the last one within 100 ms so long searches stay compact
+	void addProgress(double incumbent, double bound, double gap, long long nodes, double milliseconds = -1) {
+		lock_guard<mutex> lock(progressMutex);
+
+		if (milliseconds < 0)
+			milliseconds = elapsedMilliseconds();
+
+		if (!progress.empty()) {
+			ProgressPoint& last = progress.back();
+			bool sameIncumbent = last.incumbent == incumbent || (isnan(last.incumbent) && isnan(incumbent));
+			bool sameBound = last.bound == bound || (isnan(last.bound) && isnan(bound));
+
+			if (sameIncumbent && sameBound && milliseconds - last.milliseconds < 100)
+				return;
+		}
+
+		progress.push_back({ milliseconds, incumbent, bound, gap, nodes });
+	}
+
+	void setResult(const string& status, double objective) {
+		this->status = status;
+		this->objective = objective;
+	}
+
+	bool write() {
+		ofstream telemetryFile(fileName, ios::trunc);
+
+		if (!telemetryFile.is_open())
+			return false;
+
+		// Unknown values are null in JSON and empty in CSV
+		auto number = [&](double value) {
+			return isnan(value) ? (format == "json" ? string("null") : string("")) : to_string(value);
+		};
+
+		vector<tuple<string, double, double>> orderedPhases = phases;
+		stable_sort(orderedPhases.begin(), orderedPhases.end(), [](const tuple<string, double, double>& a, const tuple<string, double, double>& b) {
+			return get<1>(a) < get<1>(b);
+		});
+
+		if (format == "json") {
+			telemetryFile << "{" << endl;
+			telemetryFile << "\t\"solver\": \"" << solver << "\", \"stories\": " << numberOfStories << ", \"sprints\": " << numberOfSprints
+				<< ", \"status\": \"" << status << "\", \"objective\": " << number(objective) << ", \"total_ms\": " << elapsedMilliseconds() << "," << endl;
+			telemetryFile << "\t\"phases\": [";
+
+			for (int p = 0; p < orderedPhases.size(); ++p) {
+				telemetryFile << (p == 0 ? "\n\t\t" : ",\n\t\t") << "{\"name\": \"" << get<0>(orderedPhases[p]) << "\", \"start_ms\": "
+					<< get<1>(orderedPhases[p]) << ", \"ms\": " << get<2>(orderedPhases[p]) << "}";
+			}
+
+			telemetryFile << "\n\t]," << endl << "\t\"progress\": [";
+
+			for (int p = 0; p < progress.size(); ++p) {
+				telemetryFile << (p == 0 ? "\n\t\t" : ",\n\t\t") << "{\"ms\": " << progress[p].milliseconds << ", \"incumbent\": " << number(progress[p].incumbent)
+					<< ", \"bound\": " << number(progress[p].bound) << ", \"gap\": " << number(progress[p].gap) << ", \"nodes\": " << progress[p].nodes << "}";
+			}
+
+			telemetryFile << "\n\t]" << endl << "}" << endl;
+		}
+		else {
+			// One table for both kinds of record, so the file can be loaded in one go and filtered by the first column
+			telemetryFile << "record,name,start_ms,ms,incumbent,bound,gap,nodes" << endl;
+			telemetryFile << "result," << solver << ",0," << elapsedMilliseconds() << "," << number(objective) << ",,," << endl;
+
+			for (tuple<string, double, double>& phase : orderedPhases)
+				telemetryFile << "phase," << get<0>(phase) << "," << get<1>(phase) << "," << get<2>(phase) << ",,,," << endl;
+
+			for (ProgressPoint& point : progress) {
+				telemetryFile << "progress,," << point.milliseconds << ",," << number(point.incumbent) << "," << number(point.bound) << ","
+					<< number(point.gap) << "," << point.nodes << endl;
+			}
+		}
+
+		telemetryFile.close();
+
+		return !telemetryFile.fail();
+	}
+};
+
+// Times a phase of the run from construction until stop() is called or the timer goes out of scope
+class ScopedPhaseTimer {
+public:
+	Telemetry& telemetry;
+	string name;
+	double startMilliseconds;
+	bool running = true;
+
+	ScopedPhaseTimer(Telemetry& telemetry, string name) : telemetry(telemetry) {
+		this->name = name;
+		this->startMilliseconds = telemetry.elapsedMilliseconds();
+	}
+
+	~ScopedPhaseTimer() {
+		stop();
+	}
+
+	void stop() {
+		if (running)
+			telemetry.addPhase(name, startMilliseconds, telemetry.elapsedMilliseconds() - startMilliseconds);
+
+		running = false;
+	}
+};
+
+// Records the incumbent, best bound, gap and node count each time CPLEX reports on the search
+ILOMIPINFOCALLBACK1(TelemetryCallback, Telemetry*, telemetry) {
+	bool incumbentFound = hasIncumbent();
+
+	telemetry->addProgress(incumbentFound ? getIncumbentObjValue() : NAN, getBestObjValue(), incumbentFound ? getMIPRelativeGap() : NAN, getNnodes());
+}
+
+// Estimates how a fixed roadmap holds up when story points slip: each scenario multiplies every story's points by
+// its own lognormal factor (median 1, so estimates are as often high as low but overruns are bigger), and a sprint
+// whose load then exceeds its capacity delivers only the share of its value that fits (capacity / load)
+// Scenarios are evaluated in blocks, with the loads of a block kept as one array per sprint so the inner loops run
+// over scenarios and vectorize, and blocks are shared out over the threads in chunks with their own random streams,
+// so the results only depend on the seed. Distributions are kept as histograms, so memory doesn't grow with the
+// number of scenarios
+class RiskEvaluator {
+public:
+	static const int blockSize = 256; // Scenarios evaluated together
+	static const int chunkSize = 64 * blockSize; // Scenarios per task (and per random stream)
+	static const int factorSteps = 4096; // Quantiles of the slip factor that are sampled from
+	static const int bins = 1000; // Histogram bins of the share of value delivered
+	static constexpr double maximumLoadRatio = 4; // Load ratios (actual over planned load) above this share the top bin
+
+	vector<int> sprintNumbers; // Sprints with stories in them
+	vector<int> capacity; // Real capacity of each of those sprints
+	vector<int> bonus;
+	vector<long long> plannedLoad;
+	vector<long long> plannedValue; // Weighted
+	vector<int> storyOffsets = { 0 }; // Stories of each sprint in storyPoints (CSR, as in PlanningInstance)
+	vector<float> storyPoints;
+	vector<float> factors; // Slip factor quantiles
+
+	long long scenarios;
+	long long totalPlannedValue = 0;
+
+	vector<long long> overflows; // Scenarios in which each sprint overflows
+	vector<vector<long long>> deliveredShares; // Histogram of the share of each sprint's value delivered
+	vector<vector<long long>> loadRatios; // Histogram of each sprint's actual load over its planned load
+	vector<long long> totalShares; // Histogram of the share of the whole roadmap's value delivered
+	double expectedValue = 0;
+
+	// capacities are the real sprint capacities (the roadmap may have been planned against smaller ones)
+	RiskEvaluator(Roadmap& roadmap, const vector<Sprint>& capacities, long long scenarios, double spread, int threads, unsigned int seed) {
+		this->scenarios = scenarios;
+
+		for (int i = 0; i < roadmap.sprints.size(); ++i) {
+			Sprint& sprint = roadmap.sprints[i];
+
+			if (sprint.sprintNumber == -1 || roadmap.sprintStories[i].empty())
+				continue;
+
+			int realCapacity = sprint.sprintCapacity;
+
+			for (const Sprint& planned : capacities) {
+				if (planned.sprintNumber == sprint.sprintNumber)
+					realCapacity = planned.sprintCapacity;
+			}
+
+			long long load = 0, value = 0;
+
+			for (int storyNumber : roadmap.sprintStories[i]) {
+				storyPoints.push_back(roadmap.instance->storyPoints[storyNumber]);
+				load += roadmap.instance->storyPoints[storyNumber];
+				value += roadmap.instance->businessValue[storyNumber];
+			}
+
+			sprintNumbers.push_back(sprint.sprintNumber);
+			capacity.push_back(realCapacity);
+			bonus.push_back(sprint.sprintBonus);
+			plannedLoad.push_back(load);
+			plannedValue.push_back(value * sprint.sprintBonus);
+			storyOffsets.push_back(storyPoints.size());
+			totalPlannedValue += value * sprint.sprintBonus;
+		}
+
+		// Quantile k of the factor is exp(spread * z), where z is the standard normal quantile of (k + 0.5) / steps
+		for (int k = 0; k < factorSteps; ++k) {
+			double probability = (k + 0.5) / factorSteps;
+			double low = -10, high = 10;
+
+			for (int iteration = 0; iteration < 60; ++iteration) {
+				double middle = (low + high) / 2;
+
+				if (0.5 * erfc(-middle / sqrt(2.0)) < probability)
+					low = middle;
+				else
+					high = middle;
+			}
+
+			factors.push_back((float)exp(spread * (low + high) / 2));
+		}
+
+		int numberOfSprints = sprintNumbers.size();
+
+		overflows.assign(numberOfSprints, 0);
+		deliveredShares.assign(numberOfSprints, vector<long long>(bins + 1, 0));
+		loadRatios.assign(numberOfSprints, vector<long long>(bins + 1, 0));
+		totalShares.assign(bins + 1, 0);
+
+		mutex resultsMutex;
+		long long numberOfChunks = (scenarios + chunkSize - 1) / chunkSize;
+		ThreadPool pool(max(1, min(threads, (int)min(numberOfChunks, (long long)INT_MAX))));
+
+		pool.run(numberOfChunks, [&](long long chunk) {
+			evaluateChunk(chunk, seed, resultsMutex);
+		});
+
+		expectedValue /= max(1LL, scenarios);
+	}
+
+	void evaluateChunk(long long chunk, unsigned int seed, mutex& resultsMutex) {
+		int numberOfSprints = sprintNumbers.size();
+		long long firstScenario = chunk * chunkSize;
+		long long lastScenario = min(scenarios, firstScenario + chunkSize);
+
+		vector<long long> chunkOverflows(numberOfSprints, 0);
+		vector<vector<long long>> chunkShares(numberOfSprints, vector<long long>(bins + 1, 0));
+		vector<vector<long long>> chunkRatios(numberOfSprints, vector<long long>(bins + 1, 0));
+		vector<long long> chunkTotals(bins + 1, 0);
+		double chunkValue = 0;
+
+		// splitmix64, started from the seed and the chunk so every chunk has its own stream
+		uint64_t state = ((uint64_t)seed << 32) ^ (uint64_t)chunk * 0x9E3779B97F4A7C15ULL;
+		auto nextRandom = [&]() {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		};
+
+		float load[blockSize];
+		float factor[blockSize];
+		double total[blockSize];
+
+		for (long long blockStart = firstScenario; blockStart < lastScenario; blockStart += blockSize) {
+			int blockScenarios = (int)min((long long)blockSize, lastScenario - blockStart);
+
+			fill(total, total + blockSize, 0.0);
+
+			for (int s = 0; s < numberOfSprints; ++s) {
+				fill(load, load + blockSize, 0.0f);
+
+				for (int k = storyOffsets[s]; k < storyOffsets[s + 1]; ++k) {
+					// Four 16-bit draws per random number (the quantile table needs 12 bits of each)
+					for (int b = 0; b < blockSize; b += 4) {
+						uint64_t random = nextRandom();
+
+						factor[b] = factors[random & (factorSteps - 1)];
+						factor[b + 1] = factors[(random >> 16) & (factorSteps - 1)];
+						factor[b + 2] = factors[(random >> 32) & (factorSteps - 1)];
+						factor[b + 3] = factors[(random >> 48) & (factorSteps - 1)];
+					}
+
+					float points = storyPoints[k];
+
+					for (int b = 0; b < blockSize; ++b)
+						load[b] += points * factor[b];
+				}
+
+				for (int b = 0; b < blockScenarios; ++b) {
+					double share = load[b] <= capacity[s] ? 1 : capacity[s] / (double)load[b];
+					double ratio = plannedLoad[s] > 0 ? load[b] / (double)plannedLoad[s] : 1;
+
+					chunkOverflows[s] += load[b] > capacity[s];
+					++chunkShares[s][(int)(share * bins)];
+					++chunkRatios[s][min(bins, (int)(ratio / maximumLoadRatio * bins))];
+					total[b] += share * plannedValue[s];
+				}
+			}
+
+			for (int b = 0; b < blockScenarios; ++b) {
+				double share = totalPlannedValue > 0 ? total[b] / totalPlannedValue : 1;
+
+				++chunkTotals[min(bins, (int)(share * bins))];
+				chunkValue += total[b];
+			}
+		}
+
+		lock_guard<mutex> lock(resultsMutex);
+
+		for (int s = 0; s < numberOfSprints; ++s) {
+			overflows[s] += chunkOverflows[s];
+
+			for (int bin = 0; bin <= bins; ++bin) {
+				deliveredShares[s][bin] += chunkShares[s][bin];
+				loadRatios[s][bin] += chunkRatios[s][bin];
+			}
+		}
+
+		for (int bin = 0; bin <= bins; ++bin)
+			totalShares[bin] += chunkTotals[bin];
+
+		expectedValue += chunkValue;
+	}
+
+	// The lower edge of the bin holding the given fraction of the scenarios, as a share of the histogram's range
+	double percentile(const vector<long long>& histogram, double fraction) {
+		long long wanted = (long long)ceil(fraction * scenarios);
+		long long seen = 0;
+
+		for (int bin = 0; bin <= bins; ++bin) {
+			seen += histogram[bin];
+
+			if (seen >= max(1LL, wanted))
+				return (double)bin / bins;
+		}
+
+		return 1;
+	}
+
+	double overflowProbability(int s) {
+		return scenarios > 0 ? (double)overflows[s] / scenarios : 0;
+	}
+
+	// The share of its capacity a sprint would have to be planned below, for it to overflow in at most maximumOverflow
+	// of the scenarios (assuming its load slips like the load it has now)
+	double capacityBuffer(int s, double maximumOverflow) {
+		double ratio = percentile(loadRatios[s], 1 - maximumOverflow) * maximumLoadRatio + maximumLoadRatio / bins;
+
+		return max(0.0, 1 - 1 / ratio);
+	}
+
+	void print(double maximumOverflow) {
+		cout << "Risk over " << scenarios << " scenarios of story point slips:" << endl;
+
+		for (int s = 0; s < sprintNumbers.size(); ++s) {
+			cout << ">> Sprint " << sprintNumbers[s] << ": overflows in " << overflowProbability(s) * 100 << "% of scenarios (planned "
+				<< plannedLoad[s] << " of " << capacity[s] << " points), weighted value P10 " << percentile(deliveredShares[s], 0.1) * plannedValue[s]
+				<< " / P50 " << percentile(deliveredShares[s], 0.5) * plannedValue[s] << " / P90 " << percentile(deliveredShares[s], 0.9) * plannedValue[s]
+				<< " of " << plannedValue[s] << endl;
+		}
+
+		double buffer = 0;
+
+		for (int s = 0; s < sprintNumbers.size(); ++s)
+			buffer = max(buffer, capacityBuffer(s, maximumOverflow));
+
+		cout << "Expected weighted business value: " << expectedValue << " of " << totalPlannedValue << " planned (P5 "
+			<< percentile(totalShares, 0.05) * totalPlannedValue << ", P50 " << percentile(totalShares, 0.5) * totalPlannedValue << ", P95 "
+			<< percentile(totalShares, 0.95) * totalPlannedValue << ")" << endl;
+		cout << "With --capacity-buffer=" << ceil(buffer * 100) / 100 << ", sprints planned to capacity overflow in at most "
+			<< maximumOverflow * 100 << "% of scenarios" << endl << endl;
+	}
+};
+
+// Writes the roadmap to the --write-roadmap file, if one was given
+void saveRoadmap(const string& fileName, Roadmap& roadmap) {
+	if (fileName != "" && !writeRoadmapFile(fileName, roadmap))
+		cout << "Cannot write roadmap file " << fileName << endl;
+}
+
+// Reductions on the instance before the CPLEX model is built: the product backlog column is dropped (it delivers no
+// value, so leaving a story out of every sprint already puts it in the backlog), and each story only gets variables
+// for the sprints it could ever be in
+// A story can't come before the sprint after the earliest sprint of each of its dependencies (so at the earliest
+// it is in the sprint given by the longest chain of dependencies above it), and it can only be in sprints whose
+// capacity is at least its story points
+class ModelPresolve {
+public:
+	const PlanningInstance& stories;
+	vector<Sprint>& sprints;
+	bool enabled;
+
+	vector<int> earliestSprint; // Earliest sprint number each story could be in (number of real sprints if none)
+	vector<int> latestSprint; // Latest sprint number each story fits in (-1 if none)
+
+	int numberOfRealSprints = 0;
+	int reachableVariables = 0;
+	int impossibleStories = 0; // Stories that can never be delivered, so have no variables at all
+	int eliminatedConstraints = 0; // Counted by the model builders as they skip constraints
+
+	ModelPresolve(const PlanningInstance& stories, vector<Sprint>& sprints, bool enabled) : stories(stories), sprints(sprints) {
+		this->enabled = enabled;
+
+		int numberOfStories = stories.numberOfStories();
+
+		for (Sprint& sprint : sprints) {
+			if (sprint.sprintNumber != -1)
+				++numberOfRealSprints;
+		}
+
+		earliestSprint.assign(numberOfStories, 0);
+		latestSprint.assign(numberOfStories, numberOfRealSprints - 1);
+
+		if (!enabled) {
+			reachableVariables = numberOfStories * sprints.size();
+			return;
+		}
+
+		// Sprint capacities in delivery order (sprint numbers go 0, 1, 2, ...)
+		vector<int> capacity(numberOfRealSprints);
+
+		for (Sprint& sprint : sprints) {
+			if (sprint.sprintNumber != -1)
+				capacity[sprint.sprintNumber] = sprint.sprintCapacity;
+		}
+
+		vector<int> order = stories.topologicalOrder();
+		vector<bool> ordered(numberOfStories, false);
+
+		for (int storyNumber : order)
+			ordered[storyNumber] = true;
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+			// Stories on a dependency cycle can never be delivered
+			if (!ordered[storyNumber])
+				earliestSprint[storyNumber] = numberOfRealSprints;
+		}
+
+		for (int storyNumber : order) {
+			int earliest = 0;
+
+			for (int d = stories.dependencyOffsets[storyNumber]; d < stories.dependencyOffsets[storyNumber + 1]; ++d)
+				earliest = max(earliest, earliestSprint[stories.dependencies[d]] + 1);
+
+			while (earliest < numberOfRealSprints && capacity[earliest] < stories.storyPoints[storyNumber])
+				++earliest;
+
+			earliestSprint[storyNumber] = earliest;
+		}
+
+		for (int storyNumber = 0; storyNumber < numberOfStories; ++storyNumber) {
+			while (latestSprint[storyNumber] >= 0 && capacity[latestSprint[storyNumber]] < stories.storyPoints[storyNumber])
+				--latestSprint[storyNumber];
+
+			if (earliestSprint[storyNumber] > latestSprint[storyNumber])
+				++impossibleStories;
+		}
+
+		for (int i = 0; i < sprints.size(); ++i) {
+			for (int j = 0; j < numberOfStories; ++j) {
+				if (reachable(i, j))
+					++reachableVariables;
+			}
+		}
+	}
+
+	// Whether story j could be in the sprint at position i (only these variables are used in the model)
+	bool reachable(int i, int j) {
+		if (!enabled)
+			return true;
+
+		int sprintNumber = sprints[i].sprintNumber;
+
+		return sprintNumber != -1 && sprintNumber >= earliestSprint[j] && sprintNumber <= latestSprint[j]
+			&& stories.storyPoints[j] <= sprints[i].sprintCapacity;
+	}
+
+	bool storyImpossible(int j) {
+		return enabled && earliestSprint[j] > latestSprint[j];
+	}
+
+	int eliminatedVariables() {
+		return stories.numberOfStories() * sprints.size() - reachableVariables;
+	}
+};
+
+// Certified upper bound on the value of any roadmap, to show how far a heuristic roadmap can be from optimal
+// Two relaxations are combined and the lower bound of the two is kept:
+// - The transport bound lets story points flow fractionally into any sprint, ignoring dependencies, so filling the
+//   highest-bonus sprints with the densest stories first solves it exactly (a fractional knapsack per sprint)
+// - The Lagrangian bound prices each sprint's capacity with a multiplier, and then each story independently takes
+//   its most valuable priced sprint within the window the presolve allows it (no earlier than its longest chain of
+//   dependencies, only sprints it fits in, and none for stories on a dependency cycle). Any multipliers give a
+//   valid bound, and subgradient steps towards the known roadmap value tighten it
+// Building the windows and groups is O(stories log stories) and each iteration O(groups * sprints), which is about
+// half a second on a million stories, so each roadmap's bound is computed once and passed on
+class RoadmapUpperBound {
+public:
+	double transportBound = 0;
+	double lagrangianBound = 0;
+	double bound = 0; // The lower of the two
+	int iterations = 0;
+
+	RoadmapUpperBound(const PlanningInstance& stories, vector<Sprint>& sprintData, long long lowerBound = 0, int maximumIterations = 100) {
+		ModelPresolve windows(stories, sprintData, true);
+
+		int numberOfStories = stories.numberOfStories();
+		vector<int> sprintPositions(windows.numberOfRealSprints, -1); // Sprint position of each sprint number
+		vector<int> bonusOrder; // Sprint positions by bonus (highest first)
+
+		for (int i = 0; i < sprintData.size(); ++i) {
+			if (sprintData[i].sprintNumber != -1) {
+				sprintPositions[sprintData[i].sprintNumber] = i;
+				bonusOrder.push_back(i);
+			}
+		}
+
+		stable_sort(bonusOrder.begin(), bonusOrder.end(), [&](int a, int b) {
+			return sprintData[a].sprintBonus > sprintData[b].sprintBonus;
+		});
+
+		// Transport bound, densest stories first (stories with no story points are free)
+		vector<int> densityOrder;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			if (!windows.storyImpossible(j))
+				densityOrder.push_back(j);
+		}
+
+		sort(densityOrder.begin(), densityOrder.end(), [&](int a, int b) {
+			bool aFree = stories.storyPoints[a] == 0;
+			bool bFree = stories.storyPoints[b] == 0;
+
+			if (aFree || bFree)
+				return aFree != bFree ? aFree : stories.businessValue[a] > stories.businessValue[b];
+
+			return (long long)stories.businessValue[a] * stories.storyPoints[b] > (long long)stories.businessValue[b] * stories.storyPoints[a];
+		});
+
+		vector<int> remainingCapacity(sprintData.size(), 0);
+		int bonusPosition = 0;
+		double marginalDensity = 0; // Value per story point of the story that fills the last of the capacity
+
+		for (int i : bonusOrder)
+			remainingCapacity[i] = max(0, sprintData[i].sprintCapacity);
+
+		for (int j : densityOrder) {
+			if (stories.storyPoints[j] == 0) {
+				transportBound += bonusOrder.empty() ? 0 : (double)stories.businessValue[j] * sprintData[bonusOrder[0]].sprintBonus;
+				continue;
+			}
+
+			double valuePerPoint = (double)stories.businessValue[j] / stories.storyPoints[j];
+			int pointsToPlace = stories.storyPoints[j];
+
+			while (pointsToPlace > 0 && bonusPosition < bonusOrder.size()) {
+				int sprintPosition = bonusOrder[bonusPosition];
+				int pointsPlaced = min(pointsToPlace, remainingCapacity[sprintPosition]);
+
+				transportBound += valuePerPoint * sprintData[sprintPosition].sprintBonus * pointsPlaced;
+				remainingCapacity[sprintPosition] -= pointsPlaced;
+				pointsToPlace -= pointsPlaced;
+
+				if (remainingCapacity[sprintPosition] == 0)
+					++bonusPosition;
+			}
+
+			if (bonusPosition == bonusOrder.size()) {
+				marginalDensity = valuePerPoint;
+				break;
+			}
+		}
+
+		// Stories with the same value, story points and window have the same Lagrangian subproblem, so it is solved
+		// once per group of them (which keeps the bound cheap on instances with millions of stories)
+		vector<tuple<int, int, int, int>> storyKeys; // (earliest sprint, latest sprint, story points, business value)
+		vector<tuple<int, int, int, int>> groups;
+		vector<long long> groupSizes;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			if (!windows.storyImpossible(j))
+				storyKeys.push_back(make_tuple(windows.earliestSprint[j], windows.latestSprint[j], stories.storyPoints[j], stories.businessValue[j]));
+		}
+
+		sort(storyKeys.begin(), storyKeys.end());
+
+		for (int k = 0; k < storyKeys.size(); ++k) {
+			if (k > 0 && storyKeys[k] == storyKeys[k - 1]) {
+				++groupSizes.back();
+			}
+			else {
+				groups.push_back(storyKeys[k]);
+				groupSizes.push_back(1);
+			}
+		}
+
+		// Lagrangian bound, starting from the prices of the transport relaxation (each sprint's bonus times the
+		// marginal density), which reproduce the transport bound when no window is restricted
+		vector<double> price(sprintData.size(), 0);
+		vector<long long> pointsTaken(sprintData.size());
+
+		for (int i : bonusOrder)
+			price[i] = sprintData[i].sprintBonus * marginalDensity;
+
+		double stepScale = 2;
+		int iterationsWithoutImprovement = 0;
+
+		lagrangianBound = INFINITY;
+
+		for (iterations = 0; iterations < maximumIterations; ++iterations) {
+			double value = 0;
+			fill(pointsTaken.begin(), pointsTaken.end(), 0);
+
+			for (int i : bonusOrder)
+				value += price[i] * max(0, sprintData[i].sprintCapacity);
+
+			for (int g = 0; g < groups.size(); ++g) {
+				int earliestSprint, latestSprint, storyPoints, businessValue;
+				tie(earliestSprint, latestSprint, storyPoints, businessValue) = groups[g];
+
+				double bestProfit = 0;
+				int bestPosition = -1;
+
+				for (int sprintNumber = earliestSprint; sprintNumber <= latestSprint; ++sprintNumber) {
+					int i = sprintPositions[sprintNumber];
+
+					if (storyPoints > sprintData[i].sprintCapacity)
+						continue;
+
+					double profit = (double)businessValue * sprintData[i].sprintBonus - price[i] * storyPoints;
+
+					if (profit > bestProfit) {
+						bestProfit = profit;
+						bestPosition = i;
+					}
+				}
+
+				value += bestProfit * groupSizes[g];
+
+				if (bestPosition != -1)
+					pointsTaken[bestPosition] += storyPoints * groupSizes[g];
+			}
+
+			if (value < lagrangianBound - 1e-9) {
+				lagrangianBound = value;
+				iterationsWithoutImprovement = 0;
+			}
+			else if (++iterationsWithoutImprovement == 10) {
+				stepScale /= 2;
+				iterationsWithoutImprovement = 0;
+			}
+
+			// Values are integers, so there is nothing left to prove once the bound is within 1 of the roadmap
+			if (lagrangianBound < lowerBound + 1)
+				break;
+
+			// Polyak step towards the known roadmap value along the capacity violations
+			double squaredNorm = 0;
+
+			for (int i : bonusOrder)
+				squaredNorm += (double)(pointsTaken[i] - sprintData[i].sprintCapacity) * (pointsTaken[i] - sprintData[i].sprintCapacity);
+
+			if (squaredNorm == 0)
+				break;
+
+			double step = stepScale * (value - lowerBound) / squaredNorm;
+
+			for (int i : bonusOrder)
+				price[i] = max(0.0, price[i] + step * (pointsTaken[i] - sprintData[i].sprintCapacity));
+		}
+
+		bound = min(transportBound, lagrangianBound);
+	}
+
+	// Business values are integers, so any roadmap is worth at most the bound rounded down
+	long long integerBound() {
+		return (long long)floor(bound + 1e-6);
+	}
+
+	// Relative gap between a roadmap's value and the bound
+	double gap(long long value) {
+		return integerBound() > 0 ? max(0.0, (double)(integerBound() - value) / integerBound()) : 0;
+	}
+};
+
+// The certified upper bound on the value of any roadmap, or the solver's own bound if it is tighter
+// value is the value of a roadmap already known, which the bound uses to tighten itself
+long long certifiedUpperBound(const PlanningInstance& stories, vector<Sprint>& sprintData, long long value, double solverUpperBound = INFINITY) {
+	long long bound = RoadmapUpperBound(stories, sprintData, value).integerBound();
+
+	if (solverUpperBound < bound)
+		bound = (long long)floor(solverUpperBound + 1e-6);
+
+	return bound;
+}
+
+// The value a heuristic can stop at, within targetGap of the upper bound (LLONG_MAX when targetGap is 0)
+long long targetRoadmapValue(long long upperBound, double targetGap) {
+	if (targetGap <= 0)
+		return LLONG_MAX;
+
+	return (long long)ceil((1 - targetGap) * upperBound - 1e-9);
+}
+
+// Prints a roadmap found without CPLEX, in the same layout as the CPLEX solution
+// Roadmaps that aren't proved optimal are followed by the upper bound (from certifiedUpperBound) and the gap to it
+void printRoadmapSolution(Roadmap& roadmap, string status, double milliseconds, long long upperBound) {
+	{
+		BufferedWriter output(cout);
+		roadmap.printSprintRoadmap(output);
+	}
+
+	cout << endl << status << endl;
+	cout << "Solved in " << milliseconds << " ms" << endl << endl;
+	cout << "Stories: " << roadmap.numberOfStories() << ", sprints: " << roadmap.sprints.size() << endl;
+	cout << "Total weighted business value: " << roadmap.calculateValue() << endl;
+
+	if (status != "Optimal") {
+		double gap = upperBound > 0 ? max(0.0, (double)(upperBound - roadmap.calculateValue()) / upperBound) : 0;
+
+		cout << "Upper bound: " << upperBound << " (certified gap " << gap * 100 << "%)" << endl;
+	}
+
+	cout << endl;
+}
+
+// Adds the original formulation to the model: one Boolean per (sprint, story), with the capacity of each sprint
+// and the dependencies of each story enforced through indicator (IloIfThen) constraints
+// Only the variables the presolve finds reachable are used
+void buildAssignmentModel(IloEnv env, IloModel model, IloArray<IloBoolVarArray> roadmap, const PlanningInstance& stories, vector<Sprint>& sprintData, ModelPresolve& presolve) {
+	int numberOfStories = stories.numberOfStories();
+	int numberOfSprints = sprintData.size();
+
+	// Total business value delivered (across the whole roadmap)
+	IloNumExpr deliveredValue(env, 0);
+
+	for (int i = 0; i < numberOfSprints; ++i) {
+		// Sum of the story points taken in the sprint i
+		IloNumExpr storyPointsTaken(env, 0);
+		int storiesThatFit = 0;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			if (!presolve.reachable(i, j))
+				continue;
+
+			// Add business value (including sprint bonus), if story is taken in this sprint
+			deliveredValue += stories.businessValue[j] * sprintData[i].sprintBonus * roadmap[i][j];
+
+			// Add story points, if story j is taken in sprint i
+			storyPointsTaken += stories.storyPoints[j] * roadmap[i][j];
+
+			++storiesThatFit;
+		}
+
+		// If the sprint has stories assigned, make sure that the sprint is not overloaded
+		if (storiesThatFit > 0)
+			model.add(IloIfThen(env, storyPointsTaken > 0, storyPointsTaken <= sprintData[i].sprintCapacity));
+		else
+			++presolve.eliminatedConstraints;
+	}
+
+	// Story is only assiged to one (or no) sprint
+	for (int j = 0; j < numberOfStories; ++j) {
+		// How many times story j is assigned in sprint i
+		IloNumExpr numberOfTimesStoryIsUsed(env, 0);
+		int sprintsItFits = 0;
+
+		for (int i = 0; i < numberOfSprints; ++i) {
+			if (presolve.reachable(i, j)) {
+				numberOfTimesStoryIsUsed += roadmap[i][j];
+				++sprintsItFits;
+			}
+		}
+
+		// Story j can be included in sprint i <= 1 times (which needs no constraint if it only fits in one sprint)
+		if (sprintsItFits > 1)
+			model.add(numberOfTimesStoryIsUsed <= 1);
+		else
+			++presolve.eliminatedConstraints;
+	}
+
+	// Add dependency constraints
+	for (int i = 0; i < numberOfSprints; ++i) {
+		for (int j = 0; j < numberOfStories; ++j) {
+			// How many dependencies the story has
+			int numberOfDependencies = stories.dependencyOffsets[j + 1] - stories.dependencyOffsets[j];
+
+			if (!presolve.reachable(i, j)) {
+				presolve.eliminatedConstraints += numberOfDependencies;
+				continue;
+			}
+
+			// No dependency-checking constraints are added for stories with no dependencies
+			for (int d = 0; d < numberOfDependencies; ++d) {
+				// The story number of the dependee story
+				int storyToCheck = stories.dependencies[stories.dependencyOffsets[j] + d];
+
+				// How many times the dependee stories havr been assigned before this sprint
+				IloNumExpr numberOfTimesDependeesPreAssigned(env, 0);
+
+				// Count how many times the dependee has been included between the first sprint and the current sprint
+				for (int sprintLookback = 0; sprintLookback < i; ++sprintLookback) {
+					if (presolve.reachable(sprintLookback, storyToCheck))
+						numberOfTimesDependeesPreAssigned += roadmap[sprintLookback][storyToCheck];
+				}
+
+				// roadmap[i][j] == 1 means that dependent story j is taken in sprint i, so dependee story d must appear in previous roadmap
+				// roadmap[i][j] == 0 means that dependent story j is not taken in sprint i, so dependee story d may or may not appear in previous roadmap
+				model.add(IloIfThen(env, roadmap[i][j] == 1, numberOfTimesDependeesPreAssigned == 1));
+
+				// NOTE - is numberOfTimesDependeesPreAssigned == 1 (per dependee, per story) better than numberOfTimesDependeesPreAssigned == numberOfDependencies (per story)?
+				// i.e. is it better to have more or fewer constraints that check the same thing?
+				// It seems to run faster to have a constraint per dependee, per story
+			}
+		}
+	}
+
+	// Objective function
+	model.add(IloMaximize(env, deliveredValue));
+}
+
+// The parts of a time-indexed model that edits to the instance change, so the model can be kept and edited rather
+// than rebuilt (only meaningful when the model was built without presolve, which fixes variables for the data)
+class TimeIndexedModelHandles {
+public:
+	IloArray<IloNumVarArray> doneBy; // Indexed by sprint position (empty for the product backlog)
+	IloRangeArray capacityRows; // Story points taken in each sprint position (empty for the product backlog)
+	IloObjective objective;
+};
+
+// Adds a time-indexed formulation to the model, which has a tighter LP relaxation than the assignment formulation
+// doneBy[i][j] == 1 means story j is delivered in sprint i or earlier, so each dependency needs a single two-term
+// row per sprint (instead of a prefix sum over every earlier sprint) and each capacity is a plain knapsack row
+// Only the variables the presolve finds reachable are used, and the rows of a story are dropped for the sprints
+// before its earliest sprint (where it can't be done yet)
+void buildTimeIndexedModel(IloEnv env, IloModel model, IloArray<IloBoolVarArray> roadmap, const PlanningInstance& stories, vector<Sprint>& sprintData, ModelPresolve& presolve,
+	TimeIndexedModelHandles* handles = NULL) {
+	int numberOfStories = stories.numberOfStories();
+	int numberOfSprints = sprintData.size();
+
+	// Total business value delivered (across the whole roadmap)
+	IloNumExpr deliveredValue(env, 0);
+
+	// Cumulative variables are implied integer by the linking rows, so they can be continuous
+	// Their upper bound of 1 also means each story is taken in at most one sprint
+	IloArray<IloNumVarArray> doneBy(env, numberOfSprints);
+
+	if (handles != NULL)
+		handles->capacityRows = IloRangeArray(env, numberOfSprints);
+
+	// Position of the latest real sprint before sprint i (-1 if there isn't one)
+	int previousSprint = -1;
+
+	for (int i = 0; i < numberOfSprints; ++i) {
+		// The product backlog delivers no value, so stories left out of every sprint are in the backlog implicitly
+		if (sprintData[i].sprintNumber == -1) {
+			if (!presolve.enabled) {
+				for (int j = 0; j < numberOfStories; ++j)
+					roadmap[i][j].setUB(0);
+
+				model.add(roadmap[i]);
+			}
+
+			continue;
+		}
+
+		doneBy[i] = IloNumVarArray(env, numberOfStories, 0, 1);
+
+		// Sum of the story points taken in the sprint i
+		IloNumExpr storyPointsTaken(env, 0);
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			// Story j can't be done yet (or ever)
+			if (presolve.enabled && (sprintData[i].sprintNumber < presolve.earliestSprint[j] || presolve.storyImpossible(j))) {
+				doneBy[i][j].setUB(0);
+				presolve.eliminatedConstraints += 1 + stories.dependencyOffsets[j + 1] - stories.dependencyOffsets[j];
+				continue;
+			}
+
+			IloNumExpr takenInSprint(env, 0);
+
+			if (presolve.reachable(i, j)) {
+				takenInSprint += roadmap[i][j];
+
+				// Add business value (including sprint bonus), if story is taken in this sprint
+				deliveredValue += stories.businessValue[j] * sprintData[i].sprintBonus * roadmap[i][j];
+
+				// Add story points, if story j is taken in sprint i
+				storyPointsTaken += stories.storyPoints[j] * roadmap[i][j];
+			}
+
+			// Story j is done by sprint i if it was done by the previous sprint or is taken in this one
+			if (previousSprint == -1)
+				model.add(doneBy[i][j] - takenInSprint == 0);
+			else
+				model.add(doneBy[i][j] - doneBy[previousSprint][j] - takenInSprint == 0);
+
+			// Story j can only be done by sprint i if each of its dependencies was done by the previous sprint
+			if (previousSprint == -1 && stories.dependencyOffsets[j + 1] > stories.dependencyOffsets[j]) {
+				roadmap[i][j].setUB(0);
+			}
+			else {
+				for (int d = stories.dependencyOffsets[j]; d < stories.dependencyOffsets[j + 1]; ++d)
+					model.add(doneBy[i][j] - doneBy[previousSprint][stories.dependencies[d]] <= 0);
+			}
+		}
+
+		// The sprint is not overloaded
+		IloRange capacityRow = IloAdd(model, storyPointsTaken <= sprintData[i].sprintCapacity);
+
+		if (handles != NULL)
+			handles->capacityRows[i] = capacityRow;
+
+		previousSprint = i;
+	}
+
+	// Objective function
+	IloObjective objective = IloAdd(model, IloMaximize(env, deliveredValue));
+
+	if (handles != NULL) {
+		handles->doneBy = doneBy;
+		handles->objective = objective;
+	}
+}
+
+// Adds the orders of SymmetryAnalysis to a model built by buildAssignmentModel or buildTimeIndexedModel, returns the
+// number of rows added
+// A twin is done by each sprint whenever the next higher-numbered twin is (one row per sprint it could be in, which
+// is tighter than comparing the sprints they are in), and each interchangeable sprint takes at least as many story
+// points as the next one in its class
+int addSymmetryBreaking(IloEnv env, IloModel model, IloArray<IloBoolVarArray> roadmap, const PlanningInstance& stories, vector<Sprint>& sprintData, ModelPresolve& presolve, SymmetryAnalysis& symmetry) {
+	vector<int> deliveryOrder; // Positions of the real sprints
+
+	for (int i = 0; i < sprintData.size(); ++i) {
+		if (sprintData[i].sprintNumber != -1)
+			deliveryOrder.push_back(i);
+	}
+
+	sort(deliveryOrder.begin(), deliveryOrder.end(), [&](int a, int b) {
+		return sprintData[a].sprintNumber < sprintData[b].sprintNumber;
+	});
+
+	int rowsAdded = 0;
+
+	for (vector<int>& twins : symmetry.storyClasses) {
+		for (int k = 1; k < twins.size(); ++k) {
+			int earlier = twins[k - 1];
+			int later = twins[k];
+
+			// Twins have the same presolve windows, so a row is only needed for each sprint the window reaches
+			for (int t = 0; t < deliveryOrder.size(); ++t) {
+				if (!presolve.reachable(deliveryOrder[t], earlier))
+					continue;
+
+				IloNumExpr doneByDifference(env, 0);
+
+				for (int u = 0; u <= t; ++u) {
+					if (presolve.reachable(deliveryOrder[u], earlier))
+						doneByDifference += roadmap[deliveryOrder[u]][earlier] - roadmap[deliveryOrder[u]][later];
+				}
+
+				model.add(doneByDifference >= 0);
+				++rowsAdded;
+			}
+		}
+	}
+
+	for (vector<int>& positions : symmetry.sprintClasses) {
+		for (int k = 1; k < positions.size(); ++k) {
+			IloNumExpr loadDifference(env, 0);
+
+			for (int j = 0; j < stories.numberOfStories(); ++j) {
+				if (presolve.reachable(positions[k - 1], j))
+					loadDifference += stories.storyPoints[j] * roadmap[positions[k - 1]][j];
+
+				if (presolve.reachable(positions[k], j))
+					loadDifference -= stories.storyPoints[j] * roadmap[positions[k]][j];
+			}
+
+			model.add(loadDifference >= 0);
+			++rowsAdded;
+		}
+	}
+
+	return rowsAdded;
+}
+
+// Measures how many validInsert probes and moveStory calls a Roadmap handles per second, starting from a greedy roadmap
+void benchmarkRoadmapMoves(shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, int numberOfProbes) {
+	Roadmap roadmap = greedyInsertStories(Roadmap(instance, sprintData));
+	mt19937 generator(1);
+
+	int movesMade = 0;
+	auto t_start = chrono::high_resolution_clock::now();
+
+	for (int probe = 0; probe < numberOfProbes; ++probe) {
+		int storyNumber = generator() % instance->numberOfStories();
+		Sprint& to = sprintData[generator() % sprintData.size()];
+		Sprint& from = roadmap.assignedSprint(storyNumber);
+
+		if (from.sprintNumber != to.sprintNumber && roadmap.validInsert(storyNumber, to)) {
+			roadmap.moveStory(storyNumber, to);
+			++movesMade;
+		}
+	}
+
+	double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - t_start).count();
+
+	cout << "Stories: " << instance->numberOfStories() << ", sprints: " << sprintData.size() << endl;
+	cout << "Probes: " << numberOfProbes << " (" << (long long)(numberOfProbes / seconds) << " per second)" << endl;
+	cout << "Moves: " << movesMade << " (" << (long long)(movesMade / seconds) << " per second)" << endl;
+	cout << "Final value: " << roadmap.calculateValue() << endl;
+}
+
+// Creates the 2D array of Boolean decision variables (roadmap[i][j] == 1 means user story j is taken in sprint i)
+IloArray<IloBoolVarArray> createRoadmapVariables(IloEnv env, int numberOfSprints, int numberOfStories) {
+	IloArray<IloBoolVarArray> roadmap(env, numberOfSprints);
+
+	for (int i = 0; i < numberOfSprints; ++i) {
+		// Sprint i is represented by an array of Boolean decision variables
+		roadmap[i] = IloBoolVarArray(env, numberOfStories);
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			// Create a Boolean decision variable
+			roadmap[i][j] = IloBoolVar(env);
+		}
+	}
+
+	return roadmap;
+}
+
+// Adds a roadmap (the sprint position of each story) as a MIP start
+void addRoadmapMIPStart(IloEnv env, IloCplex cplex, IloArray<IloBoolVarArray> roadmap, vector<Sprint>& sprintData, vector<int> storySprint,
+	const PlanningInstance* stories = NULL, SymmetryAnalysis* symmetry = NULL, IloCplex::MIPStartEffort effort = IloCplex::MIPStartAuto) {
+	IloNumVarArray startVar(env);
+	IloNumArray startVal(env);
+
+	// A start that breaks the symmetry rows of the model would be rejected, so it is put in their order first
+	if (symmetry != NULL)
+		storySprint = symmetry->orderRoadmap(storySprint, sprintData, *stories);
+
+	for (int storyNumber = 0; storyNumber < storySprint.size(); ++storyNumber) {
+		if (storySprint[storyNumber] == -1)
+			continue;
+
+		Sprint sprint = sprintData[storySprint[storyNumber]];
+
+		if (sprint.sprintNumber != -1) {
+			startVar.add(roadmap[sprint.sprintNumber][storyNumber]);
+			startVal.add(1);
+		}
+	}
+
+	cplex.addMIPStart(startVar, startVal, effort);
+
+	startVal.end();
+	startVar.end();
+}
+
+// The CPLEX settings the planner exposes on top of the time limit and thread count (which every solver shares)
+// A profile gives the starting values and any setting given explicitly overrides it, whatever order they come in
+class CplexParameters {
+public:
+	string profile = "balanced"; // fast, balanced or prove-optimal
+	double mipGap = -1; // Relative gap at which CPLEX stops (-1 leaves it to the profile)
+	int emphasis = -1; // MIP emphasis: 0 balanced, 1 feasibility, 2 optimality, 3 best bound, 4 hidden feasibility
+	int workMemory = -1; // Megabytes of working memory before CPLEX starts using node files
+	int treeMemory = -1; // Megabytes the branch and bound tree may use before CPLEX gives up
+	int nodeFile = -1; // Where nodes go once working memory is used up: 0 nowhere, 1 compressed in memory, 2 disk, 3 compressed on disk
+
+	static vector<string> profiles() {
+		return { "fast", "balanced", "prove-optimal" };
+	}
+
+	// Sets one parameter from its command line name and value, returns false if either isn't valid
+	bool set(const string& name, const string& value) {
+		static const vector<string> emphasisNames = { "balanced", "feasibility", "optimality", "bestbound", "hiddenfeas" };
+		static const vector<string> nodeFileNames = { "none", "memory", "disk", "compressed-disk" };
+		double number;
+		int integer;
+
+		if (name == "profile") {
+			vector<string> names = profiles();
+
+			if (find(names.begin(), names.end(), value) == names.end())
+				return false;
+
+			profile = value;
+		}
+		else if (name == "mip-gap" && parseDouble(value, number) && number >= 0 && number < 1) {
+			mipGap = number;
+		}
+		else if (name == "emphasis" && find(emphasisNames.begin(), emphasisNames.end(), value) != emphasisNames.end()) {
+			emphasis = find(emphasisNames.begin(), emphasisNames.end(), value) - emphasisNames.begin();
+		}
+		else if (name == "work-mem" && parseInt(value, integer) && integer > 0) {
+			workMemory = integer;
+		}
+		else if (name == "tree-memory" && parseInt(value, integer) && integer > 0) {
+			treeMemory = integer;
+		}
+		else if (name == "node-file" && find(nodeFileNames.begin(), nodeFileNames.end(), value) != nodeFileNames.end()) {
+			nodeFile = find(nodeFileNames.begin(), nodeFileNames.end(), value) - nodeFileNames.begin();
+		}
+		else {
+			return false;
+		}
+
+		return true;
+	}
+
+	// The profile's values with the explicit settings laid over them (-1 leaves CPLEX's own default)
+	CplexParameters resolved() const {
+		CplexParameters settings;
+		settings.profile = profile;
+
+		if (profile == "fast") {
+			// Good roadmaps quickly: feasible solutions first, and stop within 1% of the bound
+			settings.mipGap = 0.01;
+			settings.emphasis = 1;
+		}
+		else if (profile == "prove-optimal") {
+			// Close the gap completely, moving the tree to compressed node files on disk rather than running out of memory
+			settings.mipGap = 0;
+			settings.emphasis = 3;
+			settings.nodeFile = 3;
+		}
+
+		if (mipGap >= 0)
+			settings.mipGap = mipGap;
+		if (emphasis >= 0)
+			settings.emphasis = emphasis;
+		if (workMemory > 0)
+			settings.workMemory = workMemory;
+		if (treeMemory > 0)
+			settings.treeMemory = treeMemory;
+		if (nodeFile >= 0)
+			settings.nodeFile = nodeFile;
+
+		return settings;
+	}
+
+	// A time limit of 0 means no limit, and 0 threads leaves the choice to CPLEX
+	void apply(IloCplex cplex, double timeLimit, int threads) const {
+		CplexParameters settings = resolved();
+
+		if (timeLimit > 0)
+			cplex.setParam(IloCplex::Param::TimeLimit, timeLimit);
+		if (threads > 0)
+			cplex.setParam(IloCplex::Param::Threads, threads);
+		if (settings.mipGap >= 0)
+			cplex.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, settings.mipGap);
+		if (settings.emphasis >= 0)
+			cplex.setParam(IloCplex::Param::Emphasis::MIP, settings.emphasis);
+		if (settings.workMemory > 0)
+			cplex.setParam(IloCplex::Param::WorkMem, settings.workMemory);
+		if (settings.treeMemory > 0)
+			cplex.setParam(IloCplex::Param::MIP::Limits::TreeMemory, settings.treeMemory);
+		if (settings.nodeFile >= 0)
+			cplex.setParam(IloCplex::Param::MIP::Strategy::File, settings.nodeFile);
+	}
+};
+
+// Reads the roadmap CPLEX found with one getValues call per sprint (rather than one getValue per variable), returns
+// the sprint position of each story (-1 if it is in none)
+// Values are rounded, since CPLEX only gets Booleans to within its integrality tolerance
+vector<int> extractRoadmap(IloEnv env, IloCplex cplex, IloArray<IloBoolVarArray> roadmap, vector<Sprint>& sprintData, int numberOfStories, ModelPresolve& presolve) {
+	vector<int> storySprint(numberOfStories, -1);
+	vector<int> sprintStories;
+
+	for (int i = 0; i < sprintData.size(); ++i) {
+		IloNumVarArray sprintVariables(env);
+		sprintStories.clear();
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			if (presolve.reachable(i, j)) {
+				sprintVariables.add(roadmap[i][j]);
+				sprintStories.push_back(j);
+			}
+		}
+
+		if (!sprintStories.empty()) {
+			IloNumArray values(env);
+			cplex.getValues(values, sprintVariables);
+
+			for (int k = 0; k < sprintStories.size(); ++k) {
+				if (values[k] > 0.5)
+					storySprint[sprintStories[k]] = i;
+			}
+
+			values.end();
+		}
+
+		sprintVariables.end();
+	}
+
+	return storySprint;
+}
+
+// Plans long roadmaps a window of sprints at a time: the first windowSize remaining sprints are solved exactly
+// (with CPLEX or the branch-and-bound solver) together with a single lookahead sprint that stands in for all the
+// later sprints, then the stories in the first sprint of the window are fixed and the window slides on by one
+// sprint. Each window starts from the previous window's roadmap, so the cost grows linearly with the number of
+// sprints instead of with the size of one model over all of them
+class RollingHorizonPlanner {
+public:
+	shared_ptr<const PlanningInstance> instance;
+	vector<Sprint> sprintData; // All sprints, including the product backlog (sprint positions match sprint numbers)
+
+	int windowSize;
+	string engine; // cplex or bnb
+	string model; // CPLEX formulation: assignment or timeindexed
+	bool presolve;
+	double windowTimeLimit; // Seconds per window (0 means no limit)
+	CplexParameters cplexParameters;
+	int threads;
+	bool breakSymmetry = true; // Adds the SymmetryAnalysis orders to every window
+
+	mt19937 generator; // Shuffles the greedy warm starts
+
+	int windowsSolved = 0;
+	bool windowsOptimal = true; // Whether every window was solved to optimality
+
+	RollingHorizonPlanner(shared_ptr<const PlanningInstance> instance, vector<Sprint> sprintData, int windowSize, string engine, string model, bool presolve, double windowTimeLimit,
+		CplexParameters cplexParameters, int threads, unsigned int seed) {
+		this->instance = instance;
+		this->sprintData = sprintData;
+		this->windowSize = max(1, windowSize);
+		this->engine = engine;
+		this->model = model;
+		this->presolve = presolve;
+		this->windowTimeLimit = windowTimeLimit;
+		this->cplexParameters = cplexParameters;
+		this->threads = threads;
+		this->generator.seed(seed);
+	}
+
+	// Solves the window with CPLEX, returns the sprint position of each story (-1 if it isn't in a sprint)
+	vector<int> solveWindowWithCplex(shared_ptr<const PlanningInstance> windowStories, vector<Sprint>& windowSprints, Roadmap& warmStart) {
+		const PlanningInstance& windowInstance = *windowStories;
+		int numberOfStories = windowInstance.numberOfStories();
+		int numberOfSprints = windowSprints.size();
+		vector<int> storySprint(numberOfStories, -1);
+
+		IloEnv env;
+
+		try {
+			IloModel windowModel(env);
+			IloArray<IloBoolVarArray> roadmap = createRoadmapVariables(env, numberOfSprints, numberOfStories);
+			ModelPresolve windowPresolve(windowInstance, windowSprints, presolve);
+
+			if (model == "timeindexed")
+				buildTimeIndexedModel(env, windowModel, roadmap, windowInstance, windowSprints, windowPresolve);
+			else
+				buildAssignmentModel(env, windowModel, roadmap, windowInstance, windowSprints, windowPresolve);
+
+			SymmetryAnalysis symmetry(windowInstance, windowSprints);
+
+			if (breakSymmetry)
+				addSymmetryBreaking(env, windowModel, roadmap, windowInstance, windowSprints, windowPresolve, symmetry);
+
+			IloCplex cplex(env);
+			cplex.setOut(env.getNullStream());
+			cplex.extract(windowModel);
+			cplexParameters.apply(cplex, windowTimeLimit, threads);
+
+			addRoadmapMIPStart(env, cplex, roadmap, windowSprints, warmStart.storySprint, &windowInstance, breakSymmetry ? &symmetry : NULL);
+
+			if (cplex.solve()) {
+				windowsOptimal = windowsOptimal && cplex.getStatus() == IloAlgorithm::Optimal;
+
+				storySprint = extractRoadmap(env, cplex, roadmap, windowSprints, numberOfStories, windowPresolve);
+
+				for (int j = 0; j < numberOfStories; ++j) {
+					if (storySprint[j] != -1 && windowSprints[storySprint[j]].sprintNumber == -1)
+						storySprint[j] = -1;
+				}
+			}
+			else {
+				// Keep the warm start if CPLEX finds nothing better in time
+				windowsOptimal = false;
+				storySprint = warmStart.storySprint;
+			}
+		}
+		catch (IloException& e) {
+			cerr << "Concert exception caught: " << e.getMessage() << endl;
+			windowsOptimal = false;
+			storySprint = warmStart.storySprint;
+		}
+
+		env.end();
+
+		for (int& position : storySprint) {
+			if (position != -1 && windowSprints[position].sprintNumber == -1)
+				position = -1;
+		}
+
+		return storySprint;
+	}
+
+	vector<int> solveWindowWithBranchAndBound(shared_ptr<const PlanningInstance> windowStories, vector<Sprint>& windowSprints, Roadmap& warmStart) {
+		BranchAndBoundSolver solver(windowStories, windowSprints, windowTimeLimit);
+		solver.breakSymmetry = breakSymmetry;
+		Roadmap incumbent = greedyStartingRoadmap(windowStories, windowSprints, generator);
+
+		if (warmStart.calculateValue() > incumbent.calculateValue())
+			incumbent = warmStart;
+
+		Roadmap roadmap = solver.solve(incumbent);
+		windowsOptimal = windowsOptimal && solver.provedOptimal;
+
+		vector<int> storySprint = roadmap.storySprint;
+
+		for (int& position : storySprint) {
+			if (position != -1 && windowSprints[position].sprintNumber == -1)
+				position = -1;
+		}
+
+		return storySprint;
+	}
+
+	Roadmap solve() {
+		const PlanningInstance& stories = *instance;
+		int numberOfStories = stories.numberOfStories();
+		int numberOfSprints = sprintData.size() - 1; // Real sprints
+
+		vector<int> fixedSprint(numberOfStories, -1); // Sprint number each story has been fixed in
+		vector<int> plannedSprint(numberOfStories, -1); // Sprint number from the latest window (the lookahead is numberOfSprints)
+
+		for (int windowStart = 0; windowStart < numberOfSprints; ++windowStart) {
+			int windowEnd = min(numberOfSprints, windowStart + windowSize); // One past the last exact sprint
+			bool lookahead = windowEnd < numberOfSprints;
+
+			// The stories still to be placed, renumbered for the window
+			vector<int> windowStoryNumbers;
+			vector<int> windowNumber(numberOfStories, -1);
+
+			for (int j = 0; j < numberOfStories; ++j) {
+				if (fixedSprint[j] == -1) {
+					windowNumber[j] = windowStoryNumbers.size();
+					windowStoryNumbers.push_back(j);
+				}
+			}
+
+			PlanningInstance windowInstance;
+
+			for (int j : windowStoryNumbers) {
+				windowInstance.businessValue.push_back(stories.businessValue[j]);
+				windowInstance.storyPoints.push_back(stories.storyPoints[j]);
+
+				// Dependencies fixed in earlier sprints are already satisfied
+				for (int d = stories.dependencyOffsets[j]; d < stories.dependencyOffsets[j + 1]; ++d) {
+					if (fixedSprint[stories.dependencies[d]] == -1)
+						windowInstance.dependencies.push_back(windowNumber[stories.dependencies[d]]);
+				}
+
+				windowInstance.dependencyOffsets.push_back(windowInstance.dependencies.size());
+			}
+
+			windowInstance.buildDependees();
+			shared_ptr<const PlanningInstance> windowStories = make_shared<const PlanningInstance>(move(windowInstance));
+
+			vector<Sprint> windowSprints;
+
+			for (int s = windowStart; s < windowEnd; ++s)
+				windowSprints.push_back(Sprint(s - windowStart, sprintData[s].sprintCapacity, sprintData[s].sprintBonus));
+
+			// The lookahead sprint has the capacity of all the later sprints and their capacity-weighted average bonus
+			if (lookahead) {
+				long long capacity = 0;
+				double weightedBonus = 0;
+
+				for (int s = windowEnd; s < numberOfSprints; ++s) {
+					capacity += sprintData[s].sprintCapacity;
+					weightedBonus += (double)sprintData[s].sprintCapacity * sprintData[s].sprintBonus;
+				}
+
+				int bonus = capacity > 0 ? (int)(weightedBonus / capacity + 0.5) : sprintData[windowEnd].sprintBonus;
+				windowSprints.push_back(Sprint(windowEnd - windowStart, (int)min(capacity, (long long)INT_MAX), bonus));
+			}
+
+			windowSprints.push_back(Sprint(-1, 0, 0));
+
+			// Warm start from the previous window's roadmap, shifted along by one sprint
+			vector<int> previousSprintNumbers(windowStoryNumbers.size(), -1);
+
+			for (int j : windowStoryNumbers) {
+				if (plannedSprint[j] != -1)
+					previousSprintNumbers[windowNumber[j]] = min(plannedSprint[j], windowEnd) - windowStart;
+			}
+
+			int storiesKept;
+			Roadmap warmStart = repairRoadmap(windowStories, windowSprints, previousSprintNumbers, 0, storiesKept);
+
+			vector<int> windowSprint = engine == "cplex"
+				? solveWindowWithCplex(windowStories, windowSprints, warmStart)
+				: solveWindowWithBranchAndBound(windowStories, windowSprints, warmStart);
+
+			++windowsSolved;
+
+			// Fix the first sprint of the window, or every sprint once the window reaches the end of the roadmap
+			for (int k = 0; k < windowStoryNumbers.size(); ++k) {
+				int j = windowStoryNumbers[k];
+				int sprintNumber = windowSprint[k] == -1 ? -1 : windowStart + windowSprints[windowSprint[k]].sprintNumber;
+
+				plannedSprint[j] = sprintNumber;
+
+				if (sprintNumber != -1 && (sprintNumber == windowStart || (!lookahead && sprintNumber < windowEnd)))
+					fixedSprint[j] = sprintNumber;
+			}
+
+			if (!lookahead)
+				break;
+		}
+
+		Roadmap roadmap(instance, sprintData);
+
+		for (int j = 0; j < numberOfStories; ++j)
+			roadmap.addStoryToSprint(j, sprintData[fixedSprint[j] != -1 ? fixedSprint[j] : numberOfSprints]);
+
+		return roadmap;
+	}
+};
+
+// Column generation over a set-partitioning model of the roadmap: each column is a set of stories that fits in one
+// sprint, and the master problem picks at most one column per sprint, takes each story at most once, and keeps each
+// story after its dependencies (with prefix sums over the sprints, as in the time-indexed model)
+// Columns respect their sprint's capacity by construction, so the LP relaxation of the master is much tighter than
+// that of the assignment model, whose indicator constraints relax to almost nothing
+// New columns are priced by a 0/1 knapsack over the sprint's capacity, with each story's value in the sprint adjusted
+// by the duals of its story and dependency rows. The sprints are priced independently, on the thread pool
+// Every round gives a Lagrangian bound (the master's value plus the best reduced cost of each sprint), so the bound
+// is certified even when the pricing stops early. Then the master is solved once with integer columns (price and
+// branch), and whatever capacity its roadmap leaves is filled greedily
+class ColumnGenerationSolver {
+public:
+	vector<Sprint> sprintData; // All sprints, including the product backlog
+	CplexParameters cplexParameters;
+	int numberOfThreads;
+	double timeLimit; // Seconds (0 means no limit), half of which may go on pricing
+
+	static const int maximumRounds = 1000;
+	static const unsigned long long maximumTableBits = 1ULL << 27; // Larger pricing problems are solved greedily
+
+	double upperBound = INFINITY;
+	double relaxationValue = 0; // Of the last master LP
+	int rounds = 0;
+	int columnsGenerated = 0;
+	bool converged = false; // No column priced out, so the LP relaxation of the whole master was solved
+	bool provedOptimal = false;
+
+	ColumnGenerationSolver(vector<Sprint> sprintData, CplexParameters cplexParameters, int numberOfThreads, double timeLimit) {
+		this->sprintData = sprintData;
+		this->cplexParameters = cplexParameters;
+		this->numberOfThreads = max(1, numberOfThreads);
+		this->timeLimit = timeLimit;
+	}
+
+	// The most valuable set of the candidate stories that fits in the capacity, by dynamic programming over the
+	// capacity (one bit per story and capacity records which stories were taken)
+	// Returns false if the table would be too large, in which case the set is filled greedily by value density
+	bool priceSprint(int capacity, const vector<int>& candidates, const vector<double>& profit, const vector<int>& points, vector<int>& chosen, double& value) {
+		vector<int> items;
+
+		chosen.clear();
+		value = 0;
+
+		for (int k = 0; k < candidates.size(); ++k) {
+			if (points[k] == 0) {
+				chosen.push_back(candidates[k]);
+				value += profit[k];
+			}
+			else if (points[k] <= capacity) {
+				items.push_back(k);
+			}
+		}
+
+		if (items.empty())
+			return true;
+
+		unsigned long long cells = (unsigned long long)capacity + 1;
+
+		if (items.size() * cells > maximumTableBits) {
+			sort(items.begin(), items.end(), [&](int a, int b) {
+				return profit[a] * points[b] > profit[b] * points[a];
+			});
+
+			for (int k : items) {
+				if (points[k] <= capacity) {
+					chosen.push_back(candidates[k]);
+					value += profit[k];
+					capacity -= points[k];
+				}
+			}
+
+			return false;
+		}
+
+		vector<double> best(cells, 0);
+		vector<uint64_t> taken((items.size() * cells + 63) / 64, 0);
+
+		for (int t = 0; t < items.size(); ++t) {
+			int storyPoints = points[items[t]];
+			double storyProfit = profit[items[t]];
+
+			for (int c = capacity; c >= storyPoints; --c) {
+				double candidate = best[c - storyPoints] + storyProfit;
+
+				if (candidate > best[c]) {
+					unsigned long long bit = t * cells + c;
+
+					best[c] = candidate;
+					taken[bit >> 6] |= 1ULL << (bit & 63);
+				}
+			}
+		}
+
+		value += best[capacity];
+
+		for (int t = items.size() - 1, c = capacity; t >= 0; --t) {
+			unsigned long long bit = t * cells + c;
+
+			if ((taken[bit >> 6] >> (bit & 63)) & 1) {
+				chosen.push_back(candidates[items[t]]);
+				c -= points[items[t]];
+			}
+		}
+
+		return true;
+	}
+
+	Roadmap solve(Roadmap start) {
+		auto startTime = chrono::steady_clock::now();
+		auto elapsed = [&]() { return chrono::duration<double>(chrono::steady_clock::now() - startTime).count(); };
+
+		const PlanningInstance& stories = *start.instance;
+		int numberOfStories = stories.numberOfStories();
+		long long startValue = start.calculateValue();
+		ModelPresolve presolve(stories, sprintData, true);
+
+		int numberOfSprints = presolve.numberOfRealSprints;
+		vector<int> sprintPositions(numberOfSprints); // Sprint position of each sprint number
+
+		for (int i = 0; i < sprintData.size(); ++i) {
+			if (sprintData[i].sprintNumber != -1)
+				sprintPositions[sprintData[i].sprintNumber] = i;
+		}
+
+		// Dependency rows: for dependency e of story j (its index in stories.dependencies) and each sprint n in
+		// j's window, j delivered by n takes no more than the dependency delivered before n
+		vector<int> rowStart(stories.dependencies.size(), -1);
+		vector<int> dependencyOwner(stories.dependencies.size());
+		vector<vector<int>> dependencyOf(numberOfStories); // Dependencies e whose dependency is each story
+		int numberOfRows = 0;
+
+		for (int j = 0; j < numberOfStories; ++j) {
+			for (int e = stories.dependencyOffsets[j]; e < stories.dependencyOffsets[j + 1]; ++e) {
+				dependencyOwner[e] = j;
+				dependencyOf[stories.dependencies[e]].push_back(e);
+
+				if (!presolve.storyImpossible(j)) {
+					rowStart[e] = numberOfRows;
+					numberOfRows += presolve.latestSprint[j] - presolve.earliestSprint[j] + 1;
+				}
+			}
+		}
+
+		// Row of dependency e in sprint n, clamped to the owner's window (-1 past its end)
+		auto dependencyRow = [&](int e, int n) {
+			int j = dependencyOwner[e];
+
+			if (rowStart[e] == -1 || n > presolve.latestSprint[j])
+				return -1;
+
+			return rowStart[e] + max(n, presolve.earliestSprint[j]) - presolve.earliestSprint[j];
+		};
+
+		// One past the last row of dependency e
+		auto rowEnd = [&](int e) {
+			int j = dependencyOwner[e];
+			return rowStart[e] + presolve.latestSprint[j] - presolve.earliestSprint[j] + 1;
+		};
+
+		IloEnv env;
+		Roadmap best = start;
+
+		try {
+			IloModel master(env);
+			IloObjective objective = IloAdd(master, IloMaximize(env));
+			IloRangeArray sprintRows = IloAdd(master, IloRangeArray(env, numberOfSprints, -IloInfinity, 1));
+			IloRangeArray storyRows = IloAdd(master, IloRangeArray(env, numberOfStories, -IloInfinity, 1));
+			IloRangeArray dependencyRows = IloAdd(master, IloRangeArray(env, numberOfRows, -IloInfinity, 0));
+			IloNumVarArray columns(env);
+			vector<int> columnSprint; // Sprint number of each column
+			vector<vector<int>> columnStories;
+
+			auto addColumn = [&](int n, const vector<int>& storyNumbers) {
+				const Sprint& sprint = sprintData[sprintPositions[n]];
+				long long value = 0;
+				vector<pair<int, int>> coefficients; // (dependency row, coefficient), merged below
+
+				for (int j : storyNumbers) {
+					value += (long long)stories.businessValue[j] * sprint.sprintBonus;
+
+					for (int e = stories.dependencyOffsets[j]; e < stories.dependencyOffsets[j + 1]; ++e) {
+						for (int row = dependencyRow(e, n); row != -1 && row < rowEnd(e); ++row)
+							coefficients.push_back(make_pair(row, 1));
+					}
+
+					for (int e : dependencyOf[j]) {
+						for (int row = dependencyRow(e, n + 1); row != -1 && row < rowEnd(e); ++row)
+							coefficients.push_back(make_pair(row, -1));
+					}
+				}
+
+				sort(coefficients.begin(), coefficients.end());
+
+				IloNumColumn column = objective((double)value) + sprintRows[n](1);
+
+				for (int j : storyNumbers)
+					column += storyRows[j](1);
+
+				for (int k = 0; k < coefficients.size();) {
+					int row = coefficients[k].first;
+					int coefficient = 0;
+
+					for (; k < coefficients.size() && coefficients[k].first == row; ++k)
+						coefficient += coefficients[k].second;
+
+					if (coefficient != 0)
+						column += dependencyRows[row](coefficient);
+				}
+
+				columns.add(IloNumVar(column, 0, 1));
+				columnSprint.push_back(n);
+				columnStories.push_back(storyNumbers);
+				column.end();
+			};
+
+			// The starting roadmap's sprints are the first columns, so the integer master always has a solution
+			for (int n = 0; n < numberOfSprints; ++n) {
+				if (!start.sprintStories[sprintPositions[n]].empty())
+					addColumn(n, start.sprintStories[sprintPositions[n]]);
+			}
+
+			int startColumns = columns.getSize();
+
+			IloCplex cplex(master);
+			cplex.setOut(env.getNullStream());
+			cplex.setParam(IloCplex::Param::Threads, numberOfThreads);
+
+			ThreadPool pool(numberOfThreads);
+			vector<double> sprintDuals(numberOfSprints), storyDuals(numberOfStories), dependencySuffix(numberOfRows);
+			vector<vector<int>> pricedStories(numberOfSprints);
+			vector<double> pricedValues(numberOfSprints);
+			vector<char> pricedExactly(numberOfSprints);
+
+			for (rounds = 0; rounds < maximumRounds; ++rounds) {
+				if (!cplex.solve())
+					break;
+
+				relaxationValue = cplex.getObjValue();
+
+				IloNumArray duals(env);
+				cplex.getDuals(duals, sprintRows);
+
+				for (int n = 0; n < numberOfSprints; ++n)
+					sprintDuals[n] = duals[n];
+
+				cplex.getDuals(duals, storyRows);
+
+				for (int j = 0; j < numberOfStories; ++j)
+					storyDuals[j] = duals[j];
+
+				// Each story's profit needs the duals of its dependency rows from a sprint on, so they are summed from
+				// the end of each window
+				if (numberOfRows > 0) {
+					cplex.getDuals(duals, dependencyRows);
+
+					for (int e = 0; e < rowStart.size(); ++e) {
+						if (rowStart[e] == -1)
+							continue;
+
+						double sum = 0;
+
+						for (int row = rowEnd(e) - 1; row >= rowStart[e]; --row) {
+							sum += duals[row];
+							dependencySuffix[row] = sum;
+						}
+					}
+				}
+
+				duals.end();
+
+				auto suffix = [&](int e, int n) {
+					int row = dependencyRow(e, n);
+					return row == -1 ? 0.0 : dependencySuffix[row];
+				};
+
+				pool.run(numberOfSprints, [&](int n) {
+					const Sprint& sprint = sprintData[sprintPositions[n]];
+					vector<int> candidates, points;
+					vector<double> profit;
+
+					for (int j = 0; j < numberOfStories; ++j) {
+						if (!presolve.reachable(sprintPositions[n], j))
+							continue;
+
+						double storyProfit = (double)stories.businessValue[j] * sprint.sprintBonus - storyDuals[j];
+
+						for (int e = stories.dependencyOffsets[j]; e < stories.dependencyOffsets[j + 1]; ++e)
+							storyProfit -= suffix(e, n);
+
+						for (int e : dependencyOf[j])
+							storyProfit += suffix(e, n + 1);
+
+						if (storyProfit > 1e-9) {
+							candidates.push_back(j);
+							profit.push_back(storyProfit);
+							points.push_back(stories.storyPoints[j]);
+						}
+					}
+
+					pricedExactly[n] = priceSprint(sprint.sprintCapacity, candidates, profit, points, pricedStories[n], pricedValues[n]);
+				});
+
+				bool allExact = true;
+				double lagrangianBound = relaxationValue;
+				int columnsAdded = 0;
+
+				for (int n = 0; n < numberOfSprints; ++n) {
+					allExact = allExact && pricedExactly[n];
+					lagrangianBound += pricedValues[n] - sprintDuals[n];
+
+					if (pricedValues[n] - sprintDuals[n] > 1e-6 && !pricedStories[n].empty()) {
+						addColumn(n, pricedStories[n]);
+						++columnsAdded;
+					}
+				}
+
+				columnsGenerated += columnsAdded;
+
+				if (allExact)
+					upperBound = min(upperBound, lagrangianBound);
+
+				if (columnsAdded == 0) {
+					converged = allExact;
+
+					if (converged)
+						upperBound = min(upperBound, relaxationValue);
+
+					break;
+				}
+
+				// Values are integers, so the starting roadmap is optimal once the bound is within 1 of it
+				if (floor(upperBound + 1e-6) <= startValue || (timeLimit > 0 && elapsed() > timeLimit / 2))
+					break;
+			}
+
+			if (floor(upperBound + 1e-6) > startValue) {
+				master.add(IloConversion(env, columns, ILOBOOL));
+				cplexParameters.apply(cplex, timeLimit > 0 ? max(1.0, timeLimit - elapsed()) : 0, numberOfThreads);
+
+				IloNumArray startValues(env, columns.getSize());
+
+				for (int k = 0; k < columns.getSize(); ++k)
+					startValues[k] = k < startColumns ? 1 : 0;
+
+				cplex.addMIPStart(columns, startValues);
+				startValues.end();
+
+				if (cplex.solve()) {
+					IloNumArray values(env);
+					cplex.getValues(values, columns);
+
+					Roadmap roadmap(start.instance, start.sprints);
+					vector<int> unassigned;
+
+					for (int k = 0; k < columns.getSize(); ++k) {
+						if (values[k] > 0.5) {
+							for (int j : columnStories[k])
+								roadmap.addStoryToSprint(j, sprintData[sprintPositions[columnSprint[k]]]);
+						}
+					}
+
+					values.end();
+
+					for (int j = 0; j < numberOfStories; ++j) {
+						if (!roadmap.isAssigned(j))
+							unassigned.push_back(j);
+					}
+
+					roadmap = greedyInsertStories(unassigned, move(roadmap), ValueDensity);
+
+					if (roadmap.calculateValue() > best.calculateValue())
+						best = roadmap;
+				}
+			}
+		}
+		catch (IloException& e) {
+			cerr << "Concert exception caught: " << e.getMessage() << endl;
+		}
+
+		env.end();
+
+		provedOptimal = best.calculateValue() >= floor(upperBound + 1e-6);
+
+		return best;
+	}
+};
+
+// Reads a size given as <stories>x<sprints>
+bool parseInstanceSize(const string& size, int& numberOfStories, int& numberOfSprints) {
+	size_t separator = size.find('x');
+
+	if (separator == string::npos)
+		return false;
+
+	return parseInt(size.substr(0, separator), numberOfStories) && parseInt(size.substr(separator + 1), numberOfSprints)
+		&& numberOfStories > 0 && numberOfSprints > 0;
+}
+
+// Command line settings (the story and sprint data files followed by optional --name=value flags)
+// The benchmark suite generates its own instances, so it doesn't take data files, and --generate writes the data
+// files instead of reading them
+// Flags can also come from a --config file (one name=value per line, # starts a comment), which the command line overrides
+class PlannerOptions {
+public:
+	string storyDataFileName;
+	string sprintDataFileName;
+
+	string solver = "cplex"; // cplex, bnb, dp, lns, restarts, greedy, decompose or colgen
+	PriorityRule priorityRule = ValueDensity; // Insertion order for --solver=greedy
+	string model = "assignment"; // CPLEX formulation: assignment or timeindexed
+	bool presolve = true; // Drop unreachable (sprint, story) variables before building the model
+	double targetGap = 0; // lns and restarts stop once their roadmap is certified within this gap of optimal (0 means never)
+	bool symmetryBreaking = true; // Order twin stories and interchangeable sprints in the exact solvers
+	bool autoDynamicProgram = true; // Solve knapsack-shaped instances by dynamic programming when an exact solver is asked for
+	double timeLimit = 0; // Seconds (0 means no limit, except for lns which defaults to 10 seconds)
+	unsigned int seed = time(NULL);
+	string benchmark; // Runs a benchmark instead of planning: roadmap, loader, suite, tune or symmetry
+	string cacheDirectory; // Where compiled copies of the data files are kept ("" means no caching)
+
+	string previousRoadmapFileName; // Roadmap to re-plan from (as written by --write-roadmap)
+	int frozenSprints = 0; // How many of the first sprints of the previous roadmap are committed
+	string roadmapOutputFileName; // Where to write the roadmap found
+
+	long long riskScenarios = 0; // Story point scenarios the roadmap found is evaluated under (0 means no risk report)
+	double estimateSpread = 0.3; // Standard deviation of the log of the factor story points slip by
+	double maximumOverflow = 0.1; // Share of scenarios a sprint may overflow in, for the suggested capacity buffer
+	double capacityBuffer = 0; // Share of each sprint's capacity kept free when planning
+
+	int restarts = 0; // Randomized greedy restarts (used for the CPLEX MIP starts, or the answer with --solver=restarts)
+	int threads = max(1, (int)thread::hardware_concurrency());
+	int mipStarts = 5; // How many of the best restarts are given to CPLEX
+	int iterations = 100; // Lagrangian iterations for --solver=decompose
+	int horizon = 0; // Sprints solved exactly in each window of a rolling horizon (0 means plan every sprint at once)
+	CplexParameters cplexParameters;
+
+	string generate; // Size of the instance to generate into the data files (<stories>x<sprints>)
+	int storiesToGenerate = 0;
+	int sprintsToGenerate = 0;
+	InstanceGenerator generator;
+
+	vector<pair<int, int>> suiteSizes = { { 20, 3 }, { 60, 6 }, { 200, 10 }, { 1000, 20 } }; // (stories, sprints)
+	vector<string> suiteSolvers = { "greedy", "restarts", "lns", "bnb", "cplex" };
+	unsigned int suiteSeeds = 3; // Instances generated for each size
+	string outputFileName; // Where the benchmark suite writes its results ("" means standard output)
+	string format = "csv"; // Benchmark suite and telemetry output: csv or json
+	string telemetryFileName; // Where the phase timings and search progress of the run are written
+	string batchFileName; // Manifest of the scenarios to plan in one run
+	string socketPath; // Unix domain socket a planning session is served on
+	string error; // Why the arguments couldn't be read, when it isn't just a bad flag
+
+	// Returns false if the arguments are not valid
+	bool parse(int argc, char* argv[]) {
+		int i = 1;
+		vector<string> files;
+		vector<string> flags;
+
+		for (; i < argc && string(argv[i]).compare(0, 2, "--") != 0; ++i)
+			files.push_back(argv[i]);
+
+		// The config file goes first so the command line overrides it
+		for (int a = i; a < argc; ++a) {
+			string argument = argv[a];
+
+			if (argument.compare(0, 9, "--config=") == 0 && !readConfigFile(argument.substr(9), flags))
+				return false;
+		}
+
+		for (; i < argc; ++i) {
+			if (string(argv[i]).compare(0, 9, "--config=") != 0)
+				flags.push_back(argv[i]);
+		}
+
+		for (string argument : flags) {
+			size_t separator = argument.find('=');
+
+			if (argument.compare(0, 2, "--") != 0 || separator == string::npos)
+				return false;
+
+			string name = argument.substr(2, separator - 2);
+			string value = argument.substr(separator + 1);
+			double number;
+			int integer;
+			long long wideInteger;
+
+			if (name == "solver" && (value == "cplex" || value == "bnb" || value == "dp" || value == "lns" || value == "restarts" || value == "greedy" || value == "decompose" || value == "colgen"))
+				solver = value;
+			else if (name == "priority" && value == "input")
+				priorityRule = InputOrder;
+			else if (name == "priority" && value == "density")
+				priorityRule = ValueDensity;
+			else if (name == "priority" && value == "critical-path")
+				priorityRule = CriticalPath;
+			else if (name == "priority" && value == "dependees")
+				priorityRule = MostDependees;
+			else if (name == "model" && (value == "assignment" || value == "timeindexed"))
+				model = value;
+			else if (name == "presolve" && (value == "on" || value == "off"))
+				presolve = value == "on";
+			else if (name == "target-gap" && parseDouble(value, number) && number >= 0 && number < 1)
+				targetGap = number;
+			else if (name == "symmetry" && (value == "on" || value == "off"))
+				symmetryBreaking = value == "on";
+			else if (name == "risk" && parseInt(value, wideInteger) && wideInteger >= 0)
+				riskScenarios = wideInteger;
+			else if (name == "estimate-spread" && parseDouble(value, number) && number >= 0)
+				estimateSpread = number;
+			else if (name == "max-overflow" && parseDouble(value, number) && number > 0 && number < 1)
+				maximumOverflow = number;
+			else if (name == "capacity-buffer" && parseDouble(value, number) && number >= 0 && number < 1)
+				capacityBuffer = number;
+			else if (name == "dp" && (value == "auto" || value == "off"))
+				autoDynamicProgram = value == "auto";
+			else if (name == "benchmark" && (value == "roadmap" || value == "loader" || value == "suite" || value == "tune" || value == "symmetry"))
+				benchmark = value;
+			else if (name == "generate" && parseInstanceSize(value, storiesToGenerate, sprintsToGenerate))
+				generate = value;
+			else if (name == "tightness" && parseDouble(value, number) && number > 0)
+				generator.capacityTightness = number;
+			else if (name == "points-skew" && parseDouble(value, number) && number > 0)
+				generator.pointsSkew = number;
+			else if (name == "value-skew" && parseDouble(value, number) && number > 0)
+				generator.valueSkew = number;
+			else if (name == "dependency-density" && parseDouble(value, number) && number >= 0)
+				generator.dependencyDensity = number;
+			else if (name == "dependency-depth" && parseInt(value, integer) && integer > 0)
+				generator.dependencyDepth = integer;
+			else if (name == "sizes" && parseSuiteSizes(value))
+				continue;
+			else if (name == "solvers" && parseSuiteSolvers(value))
+				continue;
+			else if (name == "seeds" && parseInt(value, integer) && integer > 0)
+				suiteSeeds = integer;
+			else if (name == "format" && (value == "csv" || value == "json"))
+				format = value;
+			else if (name == "output" && value != "")
+				outputFileName = value;
+			else if (name == "batch" && value != "")
+				batchFileName = value;
+			else if (name == "serve" && value != "")
+				socketPath = value;
+			else if (name == "telemetry" && value != "")
+				telemetryFileName = value;
+			else if (name == "cache-dir" && value != "")
+				cacheDirectory = value;
+			else if (name == "previous" && value != "")
+				previousRoadmapFileName = value;
+			else if (name == "freeze-sprints" && parseInt(value, integer) && integer >= 0)
+				frozenSprints = integer;
+			else if (name == "write-roadmap" && value != "")
+				roadmapOutputFileName = value;
+			else if (name == "time-limit" && parseDouble(value, number) && number >= 0)
+				timeLimit = number;
+			else if (name == "seed" && parseInt(value, wideInteger) && wideInteger >= 0 && wideInteger <= UINT_MAX)
+				seed = wideInteger;
+			else if (name == "restarts" && parseInt(value, integer) && integer >= 0)
+				restarts = integer;
+			else if (name == "threads" && parseInt(value, integer) && integer > 0)
+				threads = integer;
+			else if (name == "mip-starts" && parseInt(value, integer) && integer > 0)
+				mipStarts = integer;
+			else if (name == "iterations" && parseInt(value, integer) && integer > 0)
+				iterations = integer;
+			else if (name == "horizon" && parseInt(value, integer) && integer >= 0)
+				horizon = integer;
+			else if (cplexParameters.set(name, value))
+				continue;
+			else
+				return false;
+		}
+
+		// Only CPLEX (through fixed variables) and the repair itself can keep sprints frozen
+		if (frozenSprints > 0 && (previousRoadmapFileName == "" || (solver != "cplex" && solver != "greedy")))
+			return false;
+
+		// The windows of a rolling horizon are solved exactly
+		if (horizon > 0 && solver != "cplex" && solver != "bnb")
+			return false;
+
+		// Heuristic-only restarts need something to run
+		if (solver == "restarts" && restarts == 0)
+			restarts = 10000;
+
+		if (benchmark == "suite" || benchmark == "tune" || benchmark == "symmetry")
+			return files.empty();
+
+		// A batch only needs data files for its capacity what-ifs
+		if (batchFileName != "" && files.empty())
+			return horizon == 0 && previousRoadmapFileName == "";
+
+		if (batchFileName != "" && (horizon > 0 || previousRoadmapFileName != ""))
+			return false;
+
+		// A server can load its backlog on request instead
+		if (socketPath != "" && files.empty())
+			return horizon == 0 && previousRoadmapFileName == "" && batchFileName == "";
+
+		if (files.size() != 2)
+			return false;
+
+		storyDataFileName = files[0];
+		sprintDataFileName = files[1];
+
+		return true;
+	}
+
+	// Adds the flags in a config file, one name=value per line (the leading -- is optional; config files can't name
+	// other config files)
+	bool readConfigFile(const string& fileName, vector<string>& flags) {
+		ifstream configFile(fileName);
+
+		if (!configFile.is_open()) {
+			error = "Cannot open config file " + fileName;
+			return false;
+		}
+
+		string line;
+		int lineNumber = 0;
+
+		while (getline(configFile, line)) {
+			++lineNumber;
+			size_t comment = line.find('#');
+
+			if (comment != string::npos)
+				line.erase(comment);
+
+			size_t first = line.find_first_not_of(" \t\r");
+
+			if (first == string::npos)
+				continue;
+
+			line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+			string flag = line.compare(0, 2, "--") == 0 ? line : "--" + line;
+
+			if (flag.compare(0, 9, "--config=") == 0) {
+				error = fileName + " line " + to_string(lineNumber) + ": a config file can't include another config file";
+				return false;
+			}
+
+			flags.push_back(flag);
+		}
+
+		return true;
+	}
+
+	// Reads a comma separated list of <stories>x<sprints> sizes
+	bool parseSuiteSizes(const string& value) {
+		suiteSizes.clear();
+
+		for (string size : splitString(value, ',')) {
+			int numberOfStories, numberOfSprints;
+
+			if (!parseInstanceSize(size, numberOfStories, numberOfSprints))
+				return false;
+
+			suiteSizes.push_back({ numberOfStories, numberOfSprints });
+		}
+
+		return !suiteSizes.empty();
+	}
+
+	// Reads a comma separated list of solvers
+	bool parseSuiteSolvers(const string& value) {
+		suiteSolvers = splitString(value, ',');
+
+		for (string suiteSolver : suiteSolvers) {
+			if (suiteSolver != "cplex" && suiteSolver != "bnb" && suiteSolver != "dp" && suiteSolver != "lns" && suiteSolver != "restarts" && suiteSolver != "greedy" && suiteSolver != "decompose" && suiteSolver != "colgen")
+				return false;
+		}
+
+		return !suiteSolvers.empty();
+	}
+};
+
+// Measurements from one solver run of the benchmark suite
+class BenchmarkRun {
+public:
+	string solver;
+	int numberOfStories, numberOfSprints;
+	unsigned int seed;
+
+	string status;
+	double buildMilliseconds = 0; // Setting up the solver (building and extracting the model for CPLEX)
+	double solveMilliseconds = 0;
+	double objective = 0;
+	double bound = 0; // Best upper bound known (the certified RoadmapUpperBound for the heuristics)
+	double gap = 0; // Relative gap between the objective and the bound
+	long long nodes = 0; // Search tree nodes explored by CPLEX or the branch-and-bound solver
+	long long processPeakKilobytes = 0; // Peak resident memory of the process so far when the run finished (see runBenchmarkSolver)
+	vector<int> storySprintNumbers; // Sprint number of each story in the roadmap found (-1 for the product backlog)
+
+	void setRoadmap(Roadmap& roadmap) {
+		objective = roadmap.calculateValue();
+		storySprintNumbers.clear();
+
+		for (int storyNumber = 0; storyNumber < roadmap.numberOfStories(); ++storyNumber)
+			storySprintNumbers.push_back(roadmap.isAssigned(storyNumber) ? roadmap.assignedSprint(storyNumber).sprintNumber : -1);
+	}
+
+	string toCsv() {
+		return solver + "," + to_string(numberOfStories) + "," + to_string(numberOfSprints) + "," + to_string(seed) + "," + status + ","
+			+ to_string(buildMilliseconds) + "," + to_string(solveMilliseconds) + "," + to_string(objective) + "," + to_string(bound) + ","
+			+ to_string(gap) + "," + to_string(processPeakKilobytes);
+	}
+
+	string toJson() {
+		return "{\"solver\": \"" + solver + "\", \"stories\": " + to_string(numberOfStories) + ", \"sprints\": " + to_string(numberOfSprints)
+			+ ", \"seed\": " + to_string(seed) + ", \"status\": \"" + status + "\", \"build_ms\": " + to_string(buildMilliseconds)
+			+ ", \"solve_ms\": " + to_string(solveMilliseconds) + ", \"objective\": " + to_string(objective) + ", \"bound\": " + to_string(bound)
+			+ ", \"gap\": " + to_string(gap) + ", \"process_peak_rss_kb\": " + to_string(processPeakKilobytes) + "}";
+	}
+};
+
+// Runs one solver on the instance without printing anything or touching any process-wide state (rand(), the peak
+// memory counter), so several can run at once on different threads and each run depends only on its seed
+// A time limit of 0 means no limit, and CPLEX records its search progress in progress when it is given
+BenchmarkRun runSolver(const string& solver, shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, PlannerOptions& options, unsigned int seed, double timeLimit, Telemetry* progress = NULL) {
+	BenchmarkRun run;
+	run.solver = solver;
+	run.numberOfStories = instance->numberOfStories();
+	run.numberOfSprints = sprintData.size() - 1;
+	run.seed = seed;
+	run.status = "Feasible";
+
+	mt19937 generator(seed);
+	long long certifiedBound = -1; // Computed up front by the solvers that stop at a target gap
+
+	auto t_start = chrono::high_resolution_clock::now();
+	auto t_buildEnd = t_start;
+
+	if (solver == "greedy") {
+		Roadmap roadmap = greedyInsertStories(Roadmap(instance, sprintData), options.priorityRule);
+		run.setRoadmap(roadmap);
+	}
+	else if (solver == "restarts") {
+		RestartPortfolio portfolio(instance, sprintData, options.restarts > 0 ? options.restarts : 10000, options.threads, 1, timeLimit, seed);
+		Roadmap greedy = greedyInsertStories(Roadmap(instance, sprintData), ValueDensity);
+		certifiedBound = certifiedUpperBound(*greedy.instance, sprintData, greedy.calculateValue());
+		portfolio.targetValue = targetRoadmapValue(certifiedBound, options.targetGap);
+		Roadmap roadmap = portfolio.run();
+		run.setRoadmap(roadmap);
+	}
+	else if (solver == "lns") {
+		LargeNeighbourhoodSearch search(instance, sprintData, timeLimit, seed);
+		Roadmap start = greedyStartingRoadmap(instance, sprintData, generator);
+		certifiedBound = certifiedUpperBound(*start.instance, sprintData, start.calculateValue());
+		search.targetValue = targetRoadmapValue(certifiedBound, options.targetGap);
+		t_buildEnd = chrono::high_resolution_clock::now();
+		Roadmap roadmap = search.solve(start);
+		run.setRoadmap(roadmap);
+	}
+	else if (solver == "decompose") {
+		ComponentDecomposition decomposition(instance, sprintData, options.threads, options.iterations, timeLimit);
+		Roadmap start = greedyStartingRoadmap(instance, sprintData, generator);
+		t_buildEnd = chrono::high_resolution_clock::now();
+		Roadmap roadmap = decomposition.solve(start);
+		run.setRoadmap(roadmap);
+		run.bound = decomposition.upperBound;
+	}
+	else if (solver == "colgen") {
+		ColumnGenerationSolver columnGeneration(sprintData, options.cplexParameters, options.threads, timeLimit);
+		Roadmap start = greedyStartingRoadmap(instance, sprintData, generator);
+		t_buildEnd = chrono::high_resolution_clock::now();
+		Roadmap roadmap = columnGeneration.solve(start);
+		run.setRoadmap(roadmap);
+
+		if (columnGeneration.provedOptimal) {
+			run.status = "Optimal";
+			run.bound = run.objective;
+		}
+		else {
+			run.bound = columnGeneration.upperBound;
+		}
+	}
+	else if (solver == "dp") {
+		Roadmap roadmap(instance, sprintData);
+		KnapsackDynamicProgram program(*instance, sprintData);
+		t_buildEnd = chrono::high_resolution_clock::now();
+
+		if (program.applicable()) {
+			roadmap = program.solve(move(roadmap));
+			run.setRoadmap(roadmap);
+			run.status = "Optimal";
+			run.bound = run.objective;
+		}
+		else {
+			run.status = "Not applicable";
+		}
+	}
+	else if (solver == "bnb") {
+		BranchAndBoundSolver search(instance, sprintData, timeLimit);
+		search.breakSymmetry = options.symmetryBreaking;
+		Roadmap incumbent = greedyStartingRoadmap(instance, sprintData, generator);
+		t_buildEnd = chrono::high_resolution_clock::now();
+		Roadmap roadmap = search.solve(incumbent);
+		run.setRoadmap(roadmap);
+		run.nodes = search.nodesExplored;
+
+		if (search.provedOptimal) {
+			run.status = "Optimal";
+			run.bound = run.objective;
+		}
+	}
+	else {
+		IloEnv env;
+
+		try {
+			IloModel model(env);
+			IloArray<IloBoolVarArray> roadmap = createRoadmapVariables(env, sprintData.size(), instance->numberOfStories());
+			ModelPresolve presolve(*instance, sprintData, options.presolve);
+
+			if (options.model == "timeindexed")
+				buildTimeIndexedModel(env, model, roadmap, *instance, sprintData, presolve);
+			else
+				buildAssignmentModel(env, model, roadmap, *instance, sprintData, presolve);
+
+			SymmetryAnalysis symmetry(*instance, sprintData);
+
+			if (options.symmetryBreaking)
+				addSymmetryBreaking(env, model, roadmap, *instance, sprintData, presolve, symmetry);
+
+			IloCplex cplex(env);
+			cplex.setOut(env.getNullStream());
+			cplex.extract(model);
+			options.cplexParameters.apply(cplex, timeLimit, options.threads);
+
+			if (progress != NULL)
+				cplex.use(TelemetryCallback(env, progress));
+
+			Roadmap warmStart = greedyStartingRoadmap(instance, sprintData, generator);
+			addRoadmapMIPStart(env, cplex, roadmap, sprintData, warmStart.storySprint, instance.get(), options.symmetryBreaking ? &symmetry : NULL);
+
+			t_buildEnd = chrono::high_resolution_clock::now();
+
+			if (cplex.solve()) {
+				ostringstream status;
+				status << cplex.getStatus();
+
+				run.status = status.str();
+				run.objective = cplex.getObjValue();
+				run.bound = cplex.getBestObjValue();
+				run.nodes = cplex.getNnodes();
+				run.storySprintNumbers = extractRoadmap(env, cplex, roadmap, sprintData, instance->numberOfStories(), presolve);
+
+				for (int& sprintNumber : run.storySprintNumbers) {
+					if (sprintNumber != -1)
+						sprintNumber = sprintData[sprintNumber].sprintNumber;
+				}
+			}
+			else {
+				run.status = "No solution";
+			}
+		}
+		catch (IloException& e) {
+			run.status = "Error";
+		}
+
+		env.end();
+	}
+
+	auto t_end = chrono::high_resolution_clock::now();
+
+	run.buildMilliseconds = chrono::duration<double, std::milli>(t_buildEnd - t_start).count();
+	run.solveMilliseconds = chrono::duration<double, std::milli>(t_end - t_buildEnd).count();
+	// Roadmaps that aren't proved optimal are measured against the certified upper bound (which only decompose
+	// and CPLEX can tighten with bounds of their own)
+	if (run.status != "Optimal" && run.status != "Not applicable" && run.status != "Error" && run.status != "No solution") {
+		if (certifiedBound < 0)
+			certifiedBound = certifiedUpperBound(*instance, sprintData, run.objective);
+
+		run.bound = run.bound > 0 ? min(run.bound, (double)certifiedBound) : certifiedBound;
+	}
+
+	run.gap = run.bound > 0 ? max(0.0, run.bound - run.objective) / run.bound : 0;
+
+	return run;
+}
+
+// Runs one solver on the instance for the benchmark suite, recording the process's peak memory so far when it ends
+// The runs share one process, so this is only the run's own peak where the peak can be reset (Linux). Elsewhere it
+// is the highest of every run so far in the suite and depends on the order they run in, so compare it across runs
+// only on Linux, or run each configuration in a suite of its own
+BenchmarkRun runBenchmarkSolver(const string& solver, shared_ptr<const PlanningInstance> instance, vector<Sprint>& sprintData, PlannerOptions& options, unsigned int seed, double timeLimit) {
+	resetPeakResidentMemory();
+
+	BenchmarkRun run = runSolver(solver, instance, sprintData, options, seed, timeLimit);
+	run.processPeakKilobytes = peakResidentKilobytes();
+
+	return run;
+}
+
+// Opens the file a report is written to (--output) and returns it, or cout when no file is given; exits if the file
+// can't be opened
+ostream& openReportOutput(const string& outputFileName, ofstream& outputFile) {
+	if (outputFileName == "")
+		return cout;
+
+	outputFile.open(outputFileName, ios::trunc);
+
+	if (!outputFile.is_open()) {
+		cout << "Cannot open output file " << outputFileName << endl;
+		exit(0);
+	}
+
+	return outputFile;
+}
+
+// Runs every solver in the suite on generated instances of every size in the suite (several seeds each), writing
+// one CSV row or JSON object per run as soon as it finishes
+void runBenchmarkSuite(PlannerOptions& options) {
+	ofstream outputFile;
+	ostream& output = openReportOutput(options.outputFileName, outputFile);
+	double timeLimit = options.timeLimit > 0 ? options.timeLimit : 10;
+	bool firstRun = true;
+
+	if (options.format == "json")
+		output << "[" << endl;
+	else
+		output << "solver,stories,sprints,seed,status,build_ms,solve_ms,objective,bound,gap,process_peak_rss_kb" << endl;
+
+	for (pair<int, int> size : options.suiteSizes) {
+		for (unsigned int seed = 1; seed <= options.suiteSeeds; ++seed) {
+			shared_ptr<const PlanningInstance> instance = make_shared<const PlanningInstance>(options.generator.generate(size.first, size.second, seed));
+			vector<Sprint> sprintData = instance->toSprintData();
+
+			for (string solver : options.suiteSolvers) {
+				BenchmarkRun run = runBenchmarkSolver(solver, instance, sprintData, options, seed, timeLimit);
+
+				if (options.format == "json")
+					output << (firstRun ? "\t" : ",\n\t") << run.toJson() << flush;
+				else
+					output << run.toCsv() << endl;
+
+				firstRun = false;
+			}
+		}
+	}
+
+	if (options.format == "json")
+		output << endl << "]" << endl;
+}
+
+// Runs CPLEX with every parameter profile on the suite's generated instances and picks the profile that reaches the
+// target value soonest. The target of an instance is the best roadmap any profile found for it (less --target-gap), a
+// run's time to target is when its incumbent first reached that value (twice the time limit if it never did), and
+// profiles are ranked by the shifted geometric mean of their times to target
+void runProfileTuning(PlannerOptions& options) {
+	ofstream outputFile;
+	ostream& output = openReportOutput(options.outputFileName, outputFile);
+	double timeLimit = options.timeLimit > 0 ? options.timeLimit : 10;
+	double failedMilliseconds = 2 * timeLimit * 1000;
+	double shift = 10; // Milliseconds added to every time so instances solved instantly don't dominate the mean
+	vector<string> profiles = CplexParameters::profiles();
+	vector<double> logTimeSums(profiles.size(), 0);
+	int numberOfInstances = 0;
+	bool firstRun = true;
+
+	if (options.format == "json")
+		output << "[" << endl;
+	else
+		output << "profile,stories,sprints,seed,status,objective,target,time_to_target_ms" << endl;
+
+	for (pair<int, int> size : options.suiteSizes) {
+		for (unsigned int seed = 1; seed <= options.suiteSeeds; ++seed) {
+			shared_ptr<const PlanningInstance> instance = make_shared<const PlanningInstance>(options.generator.generate(size.first, size.second, seed));
+			vector<Sprint> sprintData = instance->toSprintData();
+			vector<BenchmarkRun> runs;
+			vector<vector<Telemetry::ProgressPoint>> progress;
+			double bestObjective = 0;
+
+			for (string profile : profiles) {
+				PlannerOptions profileOptions = options;
+				profileOptions.cplexParameters.profile = profile;
+				Telemetry telemetry("", options.format);
+				runs.push_back(runSolver("cplex", instance, sprintData, profileOptions, seed, timeLimit, &telemetry));
+				progress.push_back(telemetry.progress);
+
+				// The final incumbent isn't always reported to the callback, so it counts as found when the run ended
+				double total = runs.back().buildMilliseconds + runs.back().solveMilliseconds;
+				progress.back().push_back({ total, runs.back().objective, NAN, NAN, 0 });
+
+				if (runs.back().status != "No solution" && runs.back().status != "Error")
+					bestObjective = max(bestObjective, runs.back().objective);
+			}
+
+			double target = bestObjective * (1 - options.targetGap);
+
+			for (int p = 0; p < profiles.size(); ++p) {
+				double timeToTarget = failedMilliseconds;
+
+				if (runs[p].status != "No solution" && runs[p].status != "Error") {
+					for (Telemetry::ProgressPoint& point : progress[p]) {
+						if (!isnan(point.incumbent) && point.incumbent >= target - 1e-6) {
+							timeToTarget = point.milliseconds;
+							break;
+						}
+					}
+				}
+
+				logTimeSums[p] += log(timeToTarget + shift);
+
+				if (options.format == "json") {
+					output << (firstRun ? "\t" : ",\n\t") << "{\"profile\": \"" << profiles[p] << "\", \"stories\": " << runs[p].numberOfStories
+						<< ", \"sprints\": " << runs[p].numberOfSprints << ", \"seed\": " << seed << ", \"status\": \"" << runs[p].status
+						<< "\", \"objective\": " << runs[p].objective << ", \"target\": " << target << ", \"time_to_target_ms\": " << timeToTarget << "}" << flush;
+				}
+				else {
+					output << profiles[p] << "," << runs[p].numberOfStories << "," << runs[p].numberOfSprints << "," << seed << "," << runs[p].status << ","
+						<< runs[p].objective << "," << target << "," << timeToTarget << endl;
+				}
+
+				firstRun = false;
+			}
+
+			++numberOfInstances;
+		}
+	}
+
+	if (options.format == "json")
+		output << endl << "]" << endl;
+
+	int bestProfile = 0;
+
+	for (int p = 0; p < profiles.size(); ++p) {
+		cout << "Profile " << profiles[p] << ": " << exp(logTimeSums[p] / max(1, numberOfInstances)) - shift << " ms mean time to target" << endl;
+
+		if (logTimeSums[p] < logTimeSums[bestProfile])
+			bestProfile = p;
+	}
+
+	cout << "Best profile: " << profiles[bestProfile] << " (--profile=" << profiles[bestProfile] << ")" << endl;
+}
+
+// Runs the exact solvers in the suite (bnb and cplex) on generated instances with and without symmetry breaking,
+// and reports how much smaller the search tree gets. Only runs that finish both ways count towards the totals,
+// since the node count of a run cut short by the time limit says nothing about the size of its tree
+void runSymmetryBenchmark(PlannerOptions& options) {
+	ofstream outputFile;
+	ostream& output = openReportOutput(options.outputFileName, outputFile);
+	double timeLimit = options.timeLimit > 0 ? options.timeLimit : 10;
+	vector<string> solvers;
+
+	for (string solver : options.suiteSolvers) {
+		if (solver == "bnb" || solver == "cplex")
+			solvers.push_back(solver);
+	}
+
+	if (solvers.empty())
+		solvers.push_back("bnb");
+
+	map<string, pair<long long, long long>> nodeTotals; // Solver to nodes (without, with) over the runs that finished
+	map<string, int> finishedRuns;
+	bool firstRun = true;
+
+	if (options.format == "json")
+		output << "[" << endl;
+	else
+		output << "solver,stories,sprints,seed,twin_classes,twin_stories,sprint_classes,status_off,status_on,nodes_off,nodes_on,solve_ms_off,solve_ms_on" << endl;
+
+	for (pair<int, int> size : options.suiteSizes) {
+		for (unsigned int seed = 1; seed <= options.suiteSeeds; ++seed) {
+			shared_ptr<const PlanningInstance> instance = make_shared<const PlanningInstance>(options.generator.generate(size.first, size.second, seed));
+			vector<Sprint> sprintData = instance->toSprintData();
+			SymmetryAnalysis symmetry(*instance, sprintData);
+
+			for (string solver : solvers) {
+				PlannerOptions solverOptions = options;
+
+				solverOptions.symmetryBreaking = false;
+				BenchmarkRun without = runBenchmarkSolver(solver, instance, sprintData, solverOptions, seed, timeLimit);
+
+				solverOptions.symmetryBreaking = true;
+				BenchmarkRun with = runBenchmarkSolver(solver, instance, sprintData, solverOptions, seed, timeLimit);
+
+				if (without.status == "Optimal" && with.status == "Optimal") {
+					nodeTotals[solver].first += without.nodes;
+					nodeTotals[solver].second += with.nodes;
+					++finishedRuns[solver];
+				}
+
+				if (options.format == "json") {
+					output << (firstRun ? "\t" : ",\n\t") << "{\"solver\": \"" << solver << "\", \"stories\": " << size.first << ", \"sprints\": " << size.second
+						<< ", \"seed\": " << seed << ", \"twin_classes\": " << symmetry.storyClasses.size() << ", \"twin_stories\": " << symmetry.twinStories()
+						<< ", \"sprint_classes\": " << symmetry.sprintClasses.size() << ", \"status_off\": \"" << without.status << "\", \"status_on\": \"" << with.status
+						<< "\", \"nodes_off\": " << without.nodes << ", \"nodes_on\": " << with.nodes << ", \"solve_ms_off\": " << without.solveMilliseconds
+						<< ", \"solve_ms_on\": " << with.solveMilliseconds << "}" << flush;
+				}
+				else {
+					output << solver << "," << size.first << "," << size.second << "," << seed << "," << symmetry.storyClasses.size() << "," << symmetry.twinStories() << ","
+						<< symmetry.sprintClasses.size() << "," << without.status << "," << with.status << "," << without.nodes << "," << with.nodes << ","
+						<< without.solveMilliseconds << "," << with.solveMilliseconds << endl;
+				}
+
+				firstRun = false;
+			}
+		}
+	}
+
+	if (options.format == "json")
+		output << endl << "]" << endl;
+
+	for (string solver : solvers) {
+		pair<long long, long long> nodes = nodeTotals[solver];
+
+		cout << solver << ": " << nodes.first << " nodes without symmetry breaking, " << nodes.second << " with";
+
+		if (nodes.first > 0)
+			cout << " (" << 100.0 * (nodes.first - nodes.second) / nodes.first << "% fewer)";
+
+		cout << " over the " << finishedRuns[solver] << " instances solved both ways" << endl;
+	}
+}
+
+// One change to the sprint capacities of a what-if scenario
+class CapacityChange {
+public:
+	int sprintNumber; // -1 changes every sprint
+	bool scale; // Multiplies the capacity by value (rounding down) instead of setting it to value
+	double value;
+};
+
+// One plan of a batch: a backlog read from its own data files, or a capacity what-if on the instance given on the
+// command line (when the data files are left empty)
+class BatchScenario {
+public:
+	string name;
+	string storyDataFileName;
+	string sprintDataFileName;
+	vector<CapacityChange> capacityChanges; // Applied in order
+};
+
+// Reads the capacity changes of a scenario: ';' separated "*factor" (scales every sprint), "<sprint>*factor" (scales
+// one sprint) or "<sprint>=capacity" (sets one sprint), returns false if any of them isn't valid
+bool parseCapacityChanges(const string& value, vector<CapacityChange>& changes) {
+	changes.clear();
+
+	for (string change : splitString(value, ';')) {
+		size_t separator = change.find_first_of("*=");
+
+		if (change == "" || separator == string::npos || separator + 1 == change.size())
+			return false;
+
+		CapacityChange capacityChange;
+		capacityChange.scale = change[separator] == '*';
+		capacityChange.sprintNumber = -1;
+
+		if (separator > 0 && !parseInt(change.data(), change.data() + separator, capacityChange.sprintNumber))
+			return false;
+
+		if (separator == 0 && !capacityChange.scale)
+			return false;
+
+		char* valueEnd;
+		capacityChange.value = strtod(change.c_str() + separator + 1, &valueEnd);
+
+		if (*valueEnd != '\0' || capacityChange.value < 0 || capacityChange.sprintNumber < -1)
+			return false;
+
+		changes.push_back(capacityChange);
+	}
+
+	return true;
+}
+
+// Applies the capacity changes of a scenario to its copy of the sprints, returns false with a description of any
+// sprint that doesn't exist
+bool applyCapacityChanges(const vector<CapacityChange>& changes, vector<Sprint>& sprintData, string& error) {
+	for (const CapacityChange& change : changes) {
+		bool found = false;
+
+		for (Sprint& sprint : sprintData) {
+			if (sprint.sprintNumber == -1 || (change.sprintNumber != -1 && sprint.sprintNumber != change.sprintNumber))
+				continue;
+
+			sprint.sprintCapacity = change.scale ? (int)floor(sprint.sprintCapacity * change.value) : (int)change.value;
+			found = true;
+		}
+
+		if (!found) {
+			error = "there is no sprint " + to_string(change.sprintNumber);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Reads a batch manifest, with the columns Scenario, Story File, Sprint File and Capacities (the last three may be
+// left empty), returns false with a description of any problem
+bool loadBatchManifest(const string& fileName, vector<BatchScenario>& scenarios, string& error) {
+	MappedFile file(fileName);
+
+	if (!file.isOpen()) {
+		error = "Cannot open batch manifest " + fileName;
+		return false;
+	}
+
+	CsvReader reader(file.data, file.size);
+	reader.nextRow(); // Skip column headers
+
+	scenarios.clear();
+
+	while (reader.nextRow()) {
+		BatchScenario scenario;
+		string fields[4];
+		const char* fieldStart;
+		const char* fieldEnd;
+
+		for (int f = 0; f < 4 && reader.hasField(); ++f) {
+			reader.nextField(fieldStart, fieldEnd);
+			fields[f] = string(fieldStart, fieldEnd);
+		}
+
+		if (reader.hasField()) {
+			error = reader.location(fileName) + ": too many fields";
+			return false;
+		}
+
+		scenario.name = fields[0];
+		scenario.storyDataFileName = fields[1];
+		scenario.sprintDataFileName = fields[2];
+
+		if (scenario.name == "") {
+			error = reader.location(fileName) + ": missing scenario name";
+			return false;
+		}
+
+		if ((scenario.storyDataFileName == "") != (scenario.sprintDataFileName == "")) {
+			error = reader.location(fileName) + ": give both data files or neither";
+			return false;
+		}
+
+		if (!parseCapacityChanges(fields[3], scenario.capacityChanges)) {
+			error = reader.location(fileName) + ": '" + fields[3] + "' is not a list of capacity changes";
+			return false;
+		}
+
+		scenarios.push_back(scenario);
+	}
+
+	return true;
+}
+
+// Plans every scenario of a batch manifest on a pool of worker threads, writing one CSV row or JSON object per
+// scenario as soon as it finishes (so rows come out in the order the scenarios finish, not the manifest order)
+// Capacity what-ifs share the instance loaded once from the command line; each scenario runs its solver on a
+// single thread, so the pool decides how many scenarios are solved at once
+void runBatch(PlannerOptions& options) {
+	vector<BatchScenario> scenarios;
+	string error;
+
+	if (!loadBatchManifest(options.batchFileName, scenarios, error)) {
+		cout << error << endl;
+		exit(0);
+	}
+
+	// The shared instance is only needed for the scenarios without data files of their own
+	shared_ptr<const PlanningInstance> sharedInstance;
+	vector<Sprint> sharedSprintData;
+
+	for (BatchScenario& scenario : scenarios) {
+		if (scenario.storyDataFileName != "")
+			continue;
+
+		if (options.storyDataFileName == "") {
+			cout << "Scenario " << scenario.name << " has no data files, so the batch needs a story data file and a sprint data file" << endl;
+			exit(0);
+		}
+
+		PlanningInstance instance;
+		bool loadedFromCache;
+
+		if (!loadPlanningInstance(options.storyDataFileName, options.sprintDataFileName, options.cacheDirectory, instance, error, loadedFromCache)) {
+			cout << error << endl;
+			exit(0);
+		}
+
+		sharedSprintData = instance.toSprintData();
+		sharedInstance = make_shared<const PlanningInstance>(move(instance));
+		break;
+	}
+
+	ofstream outputFile;
+	ostream& output = openReportOutput(options.outputFileName, outputFile);
+	mutex outputMutex;
+	bool firstScenario = true;
+
+	if (options.format == "json")
+		output << "[" << endl;
+	else
+		output << "scenario,solver,stories,sprints,status,solve_ms,objective,bound,gap,roadmap" << endl;
+
+	PlannerOptions scenarioOptions = options;
+	scenarioOptions.threads = 1;
+
+	double timeLimit = options.timeLimit > 0 ? options.timeLimit : (options.solver == "lns" ? 10 : 0);
+	ThreadPool pool(min(options.threads, max(1, (int)scenarios.size())));
+
+	pool.run(scenarios.size(), [&](int s) {
+		BatchScenario& scenario = scenarios[s];
+		BenchmarkRun run;
+		string scenarioError;
+
+		run.solver = options.solver;
+		run.numberOfStories = run.numberOfSprints = 0;
+		run.status = "Error";
+
+		if (scenario.storyDataFileName != "") {
+			PlanningInstance instance;
+			bool loadedFromCache;
+
+			if (loadPlanningInstance(scenario.storyDataFileName, scenario.sprintDataFileName, options.cacheDirectory, instance, scenarioError, loadedFromCache)) {
+				vector<Sprint> sprintData = instance.toSprintData();
+
+				if (applyCapacityChanges(scenario.capacityChanges, sprintData, scenarioError))
+					run = runSolver(options.solver, make_shared<const PlanningInstance>(move(instance)), sprintData, scenarioOptions, options.seed, timeLimit);
+			}
+		}
+		else {
+			vector<Sprint> sprintData = sharedSprintData;
+
+			if (applyCapacityChanges(scenario.capacityChanges, sprintData, scenarioError))
+				run = runSolver(options.solver, sharedInstance, sprintData, scenarioOptions, options.seed, timeLimit);
+		}
+
+		string roadmap;
+
+		for (int j = 0; j < run.storySprintNumbers.size(); ++j)
+			roadmap += (j == 0 ? "" : options.format == "json" ? ", " : ";") + to_string(run.storySprintNumbers[j]);
+
+		lock_guard<mutex> lock(outputMutex);
+
+		if (scenarioError != "")
+			cout << "Scenario " << scenario.name << ": " << scenarioError << endl;
+
+		if (options.format == "json") {
+			output << (firstScenario ? "\t" : ",\n\t") << "{\"scenario\": " << jsonString(scenario.name) << ", \"solver\": \"" << run.solver
+				<< "\", \"stories\": " << run.numberOfStories << ", \"sprints\": " << run.numberOfSprints << ", \"status\": \"" << run.status
+				<< "\", \"solve_ms\": " << run.buildMilliseconds + run.solveMilliseconds << ", \"objective\": " << run.objective
+				<< ", \"bound\": " << run.bound << ", \"gap\": " << run.gap << ", \"roadmap\": [" << roadmap << "]}" << flush;
+		}
+		else {
+			output << scenario.name << "," << run.solver << "," << run.numberOfStories << "," << run.numberOfSprints << "," << run.status << ","
+				<< run.buildMilliseconds + run.solveMilliseconds << "," << run.objective << "," << run.bound << "," << run.gap << "," << roadmap << endl;
+		}
+
+		firstScenario = false;
+	});
+
+	if (options.format == "json")
+		output << endl << "]" << endl;
+}
+
+// A planning session kept in memory by --serve: the instance, the last roadmap and the CPLEX model built for them
+// Edits change the instance in place, and once the CPLEX model is built they change it in place too (capacities are
+// bounds of the capacity rows, business values and story points are coefficients, and dependencies add rows), so
+// nothing is copied or rebuilt between solves. Each solve starts from the last roadmap, repaired to fit the edits since
+class PlanningSession {
+public:
+	PlannerOptions& options;
+	bool loaded = false;
+	shared_ptr<PlanningInstance> instance; // Shared with the roadmaps of a solve, which end before the next edit
+	vector<Sprint> sprintData;
+	vector<int> lastSprintNumbers; // Sprint number of each story in the last roadmap (-1 for the product backlog)
+
+	// Time-indexed CPLEX model of the instance, built by the first cplex solve after a load
+	// It is built without presolve or symmetry rows, since both depend on the data the edits change
+	IloEnv env;
+	bool modelBuilt = false;
+	IloModel model;
+	IloCplex cplex;
+	IloArray<IloBoolVarArray> variables;
+	TimeIndexedModelHandles handles;
+	shared_ptr<ModelPresolve> presolve; // Disabled, but extractRoadmap needs one
+
+	PlanningSession(PlannerOptions& options) : options(options) {
+	}
+
+	~PlanningSession() {
+		env.end();
+	}
+
+	static string failure(const string& error) {
+		return "{\"ok\": false, \"error\": " + jsonString(error) + "}";
+	}
+
+	// Answers one request line with one line of JSON:
+	//   load <story data file> <sprint data file>
+	//   story <story> [value=<business value>] [points=<story points>]
+	//   capacity <changes> (as in a batch manifest: "*0.9", "2*1.5" or "3=40", ';' separated)
+	//   depend <story> <dependency>
+	//   solve [solver] [time limit in seconds]
+	//   roadmap
+	string handle(const string& request) {
+		vector<string> words;
+
+		for (string word : splitString(request, ' ')) {
+			if (word != "")
+				words.push_back(word);
+		}
+
+		if (words.empty())
+			return failure("empty request");
+
+		string command = words[0];
+
+		if (command == "load" && words.size() == 3)
+			return load(words[1], words[2]);
+
+		if (!loaded)
+			return failure("no backlog is loaded");
+
+		if (command == "story" && words.size() >= 3)
+			return editStory(words);
+
+		if (command == "capacity" && words.size() == 2)
+			return editCapacities(words[1]);
+
+		if (command == "depend" && words.size() == 3)
+			return addDependency(words[1], words[2]);
+
+		if (command == "solve" && words.size() <= 3) {
+			string solver = words.size() > 1 ? words[1] : options.solver;
+			double timeLimit = options.timeLimit;
+
+			if (solver != "greedy" && solver != "lns" && solver != "bnb" && solver != "decompose" && solver != "colgen" && solver != "cplex")
+				return failure("the server solves with greedy, lns, bnb, decompose, colgen or cplex");
+
+			// A time limit that isn't a number would read as 0, which means no limit at all
+			if (words.size() > 2) {
+				if (!parseDouble(words[2], timeLimit) || timeLimit < 0)
+					return failure("'" + words[2] + "' is not a time limit in seconds");
+			}
+
+			return solve(solver, timeLimit);
+		}
+
+		if (command == "roadmap" && words.size() == 1) {
+			string reply = "{\"ok\": true, \"story_sprints\": [";
+
+			for (int j = 0; j < lastSprintNumbers.size(); ++j)
+				reply += (j == 0 ? "" : ", ") + to_string(lastSprintNumbers[j]);
+
+			return reply + "]}";
+		}
+
+		return failure("unknown request '" + request + "'");
+	}
+
+	string load(const string& storyDataFileName, const string& sprintDataFileName) {
+		shared_ptr<PlanningInstance> loadedInstance = make_shared<PlanningInstance>();
+		string error;
+		bool loadedFromCache;
+
+		auto t_start = chrono::high_resolution_clock::now();
+
+		if (!loadPlanningInstance(storyDataFileName, sprintDataFileName, options.cacheDirectory, *loadedInstance, error, loadedFromCache))
+			return failure(error);
+
+		discardModel();
+
+		instance = loadedInstance;
+		sprintData = instance->toSprintData();
+		lastSprintNumbers.clear();
+		loaded = true;
+
+		auto t_end = chrono::high_resolution_clock::now();
+
+		return "{\"ok\": true, \"stories\": " + to_string(instance->numberOfStories()) + ", \"sprints\": " + to_string(instance->sprints.size())
+			+ ", \"load_ms\": " + to_string(chrono::duration<double, std::milli>(t_end - t_start).count()) + "}";
+	}
+
+	// Drops the CPLEX model, so the next cplex solve builds it again
+	void discardModel() {
+		if (!modelBuilt)
+			return;
+
+		env.end();
+		env = IloEnv();
+		presolve.reset();
+		modelBuilt = false;
+	}
+
+	bool parseStory(const string& word, int& storyNumber) {
+		return parseInt(word.data(), word.data() + word.size(), storyNumber) && storyNumber >= 0 && storyNumber < instance->numberOfStories();
+	}
+
+	string editStory(const vector<string>& words) {
+		int storyNumber;
+
+		if (!parseStory(words[1], storyNumber))
+			return failure("there is no story " + words[1]);
+
+		int businessValue = instance->businessValue[storyNumber];
+		int storyPoints = instance->storyPoints[storyNumber];
+
+		for (int w = 2; w < words.size(); ++w) {
+			size_t separator = words[w].find('=');
+			string name = words[w].substr(0, separator);
+			int value;
+
+			if (separator == string::npos || !parseInt(words[w].data() + separator + 1, words[w].data() + words[w].size(), value) || value < 0)
+				return failure("'" + words[w] + "' is not value=<number> or points=<number>");
+
+			if (name == "value")
+				businessValue = value;
+			else if (name == "points")
+				storyPoints = value;
+			else
+				return failure("'" + words[w] + "' is not value=<number> or points=<number>");
+		}
+
+		instance->businessValue[storyNumber] = businessValue;
+		instance->storyPoints[storyNumber] = storyPoints;
+
+		if (modelBuilt) {
+			try {
+				for (int i = 0; i < instance->sprints.size(); ++i) {
+					handles.objective.setLinearCoef(variables[i][storyNumber], (double)businessValue * sprintData[i].sprintBonus);
+					handles.capacityRows[i].setLinearCoef(variables[i][storyNumber], storyPoints);
+				}
+			}
+			catch (IloException& e) {
+				cerr << "Concert exception caught: " << e.getMessage() << endl;
+				discardModel();
+			}
+		}
+
+		return "{\"ok\": true}";
+	}
+
+	string editCapacities(const string& value) {
+		vector<CapacityChange> changes;
+		vector<Sprint> changedSprints = sprintData;
+		string error;
+
+		if (!parseCapacityChanges(value, changes))
+			return failure("'" + value + "' is not a list of capacity changes");
+
+		if (!applyCapacityChanges(changes, changedSprints, error))
+			return failure(error);
+
+		sprintData = changedSprints;
+
+		// The real sprints come first in sprintData, in the same order as in the instance
+		for (int i = 0; i < instance->sprints.size(); ++i)
+			instance->sprints[i].sprintCapacity = sprintData[i].sprintCapacity;
+
+		if (modelBuilt) {
+			try {
+				for (int i = 0; i < instance->sprints.size(); ++i)
+					handles.capacityRows[i].setUB(sprintData[i].sprintCapacity);
+			}
+			catch (IloException& e) {
+				cerr << "Concert exception caught: " << e.getMessage() << endl;
+				discardModel();
+			}
+		}
+
+		return "{\"ok\": true}";
+	}
+
+	// Whether the story depends on the other story, directly or through other dependencies (or is that story)
+	bool dependsOn(int storyNumber, int otherStoryNumber) {
+		vector<char> visited(instance->numberOfStories(), false);
+		vector<int> pending = { storyNumber };
+
+		visited[storyNumber] = true;
+
+		while (!pending.empty()) {
+			int current = pending.back();
+			pending.pop_back();
+
+			if (current == otherStoryNumber)
+				return true;
+
+			for (int d = instance->dependencyOffsets[current]; d < instance->dependencyOffsets[current + 1]; ++d) {
+				if (!visited[instance->dependencies[d]]) {
+					visited[instance->dependencies[d]] = true;
+					pending.push_back(instance->dependencies[d]);
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// Inserts the dependency into both CSR arrays, unless it would close a cycle
+	string addDependency(const string& story, const string& dependency) {
+		int storyNumber, dependencyNumber;
+
+		if (!parseStory(story, storyNumber))
+			return failure("there is no story " + story);
+
+		if (!parseStory(dependency, dependencyNumber))
+			return failure("there is no story " + dependency);
+
+		PlanningInstance& stories = *instance;
+		auto first = stories.dependencies.begin() + stories.dependencyOffsets[storyNumber];
+		auto last = stories.dependencies.begin() + stories.dependencyOffsets[storyNumber + 1];
+
+		if (find(first, last, dependencyNumber) != last)
+			return "{\"ok\": true}";
+
+		if (dependsOn(dependencyNumber, storyNumber))
+			return failure("story " + dependency + " already depends on story " + story + ", so the dependency would close a cycle");
+
+		stories.dependencies.insert(last, dependencyNumber);
+
+		for (int j = storyNumber + 1; j < stories.dependencyOffsets.size(); ++j)
+			++stories.dependencyOffsets[j];
+
+		// Each story's dependees stay in story number order, as buildDependees leaves them
+		auto firstDependee = stories.dependees.begin() + stories.dependeeOffsets[dependencyNumber];
+		auto lastDependee = stories.dependees.begin() + stories.dependeeOffsets[dependencyNumber + 1];
+
+		stories.dependees.insert(upper_bound(firstDependee, lastDependee, storyNumber), storyNumber);
+
+		for (int j = dependencyNumber + 1; j < stories.dependeeOffsets.size(); ++j)
+			++stories.dependeeOffsets[j];
+
+		// The story can't be in the first sprint, and is only done by a later sprint if the dependency was done by the
+		// sprint before, as in buildTimeIndexedModel
+		if (modelBuilt) {
+			try {
+				variables[0][storyNumber].setUB(0);
+
+				for (int i = 1; i < stories.sprints.size(); ++i)
+					model.add(handles.doneBy[i][storyNumber] - handles.doneBy[i - 1][dependencyNumber] <= 0);
+			}
+			catch (IloException& e) {
+				cerr << "Concert exception caught: " << e.getMessage() << endl;
+				discardModel();
+			}
+		}
+
+		return "{\"ok\": true}";
+	}
+
+	// Solves the model with CPLEX from the start roadmap, building the model first if there isn't one yet
+	Roadmap solveWithCplex(Roadmap& start, double timeLimit, string& status, double& bound) {
+		int numberOfStories = instance->numberOfStories();
+
+		status = "No solution";
+
+		try {
+			if (!modelBuilt) {
+				model = IloModel(env);
+				variables = createRoadmapVariables(env, sprintData.size(), numberOfStories);
+				presolve = make_shared<ModelPresolve>(*instance, sprintData, false);
+				buildTimeIndexedModel(env, model, variables, *instance, sprintData, *presolve, &handles);
+
+				cplex = IloCplex(env);
+				cplex.setOut(env.getNullStream());
+				cplex.extract(model);
+				modelBuilt = true;
+			}
+
+			options.cplexParameters.apply(cplex, timeLimit, options.threads);
+
+			// The starts of the last solve may not fit the edits since
+			if (cplex.getNMIPStarts() > 0)
+				cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+
+			addRoadmapMIPStart(env, cplex, variables, sprintData, start.storySprint);
+
+			// The last roadmap as it was, which CPLEX repairs itself (real sprint positions match sprint numbers)
+			if (!lastSprintNumbers.empty())
+				addRoadmapMIPStart(env, cplex, variables, sprintData, lastSprintNumbers, NULL, NULL, IloCplex::MIPStartRepair);
+
+			if (cplex.solve()) {
+				ostringstream cplexStatus;
+				cplexStatus << cplex.getStatus();
+
+				vector<int> storySprint = extractRoadmap(env, cplex, variables, sprintData, numberOfStories, *presolve);
+				Roadmap roadmap(instance, sprintData);
+
+				for (int j = 0; j < numberOfStories; ++j) {
+					if (storySprint[j] != -1)
+						roadmap.addStoryToSprint(j, sprintData[storySprint[j]]);
+				}
+
+				status = cplexStatus.str();
+				bound = cplex.getBestObjValue();
+
+				return roadmap;
+			}
+		}
+		catch (IloException& e) {
+			status = "Error";
+		}
+
+		return start;
+	}
+
+	string solve(const string& solver, double timeLimit) {
+		auto t_start = chrono::high_resolution_clock::now();
+
+		// The last roadmap, repaired to fit the edits since, unless the greedy roadmap is better
+		mt19937 generator(options.seed);
+		Roadmap start = greedyStartingRoadmap(instance, sprintData, generator);
+
+		if (!lastSprintNumbers.empty()) {
+			int storiesKept;
+			Roadmap repaired = repairRoadmap(instance, sprintData, lastSprintNumbers, 0, storiesKept);
+
+			if (repaired.calculateValue() > start.calculateValue())
+				start = repaired;
+		}
+
+		Roadmap roadmap;
+		string status = "Feasible";
+		double bound = INFINITY; // The solver's own bound
+		long long certifiedBound = -1; // Computed up front when the solver stops at a target gap
+
+		if (solver == "greedy") {
+			roadmap = start;
+		}
+		else if (solver == "lns") {
+			LargeNeighbourhoodSearch search(instance, sprintData, timeLimit > 0 ? timeLimit : 1, options.seed);
+			certifiedBound = certifiedUpperBound(*instance, sprintData, start.calculateValue());
+			search.targetValue = targetRoadmapValue(certifiedBound, options.targetGap);
+			roadmap = search.solve(start);
+		}
+		else if (solver == "bnb") {
+			BranchAndBoundSolver search(instance, sprintData, timeLimit);
+			search.breakSymmetry = options.symmetryBreaking;
+			roadmap = search.solve(start);
+
+			if (search.provedOptimal)
+				status = "Optimal";
+		}
+		else if (solver == "decompose") {
+			ComponentDecomposition decomposition(instance, sprintData, options.threads, options.iterations, timeLimit);
+			roadmap = decomposition.solve(start);
+			bound = decomposition.upperBound;
+		}
+		else if (solver == "colgen") {
+			ColumnGenerationSolver columnGeneration(sprintData, options.cplexParameters, options.threads, timeLimit);
+			roadmap = columnGeneration.solve(start);
+			bound = columnGeneration.upperBound;
+
+			if (columnGeneration.provedOptimal)
+				status = "Optimal";
+		}
+		else {
+			roadmap = solveWithCplex(start, timeLimit, status, bound);
+		}
+
+		long long value = roadmap.calculateValue();
+		int storiesMoved = 0;
+
+		if (status == "Optimal")
+			bound = value;
+		else if (certifiedBound >= 0)
+			bound = min(bound, (double)certifiedBound);
+		else
+			bound = certifiedUpperBound(*instance, sprintData, value, bound);
+
+		vector<int> sprintNumbers(roadmap.numberOfStories(), -1);
+
+		for (int j = 0; j < sprintNumbers.size(); ++j) {
+			if (roadmap.isAssigned(j))
+				sprintNumbers[j] = roadmap.assignedSprint(j).sprintNumber;
+
+			if (j < lastSprintNumbers.size() && sprintNumbers[j] != lastSprintNumbers[j])
+				++storiesMoved;
+		}
+
+		lastSprintNumbers = sprintNumbers;
+
+		auto t_end = chrono::high_resolution_clock::now();
+		double gap = bound > 0 ? max(0.0, bound - value) / bound : 0;
+
+		ostringstream reply;
+		reply.precision(12);
+		reply << "{\"ok\": true, \"solver\": " << jsonString(solver) << ", \"status\": " << jsonString(status) << ", \"value\": " << value
+			<< ", \"bound\": " << bound << ", \"gap\": " << gap << ", \"stories_moved\": " << storiesMoved
+			<< ", \"solve_ms\": " << chrono::duration<double, std::milli>(t_end - t_start).count() << "}";
+
+		return reply.str();
+	}
+};
+
+// Serves a planning session on a Unix domain socket, one connection at a time: each request is a line and each reply
+// a line of JSON (see PlanningSession::handle), "quit" closes the connection and "shutdown" stops the server
+void runServer(PlannerOptions& options) {
+#ifdef _WIN32
+	cout << "--serve needs Unix domain sockets, which this build doesn't support" << endl;
+	exit(0);
+#else
+	PlanningSession session(options);
+
+	if (options.storyDataFileName != "")
+		cout << session.load(options.storyDataFileName, options.sprintDataFileName) << endl;
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (options.socketPath.size() >= sizeof(address.sun_path)) {
+		cout << "Socket path " << options.socketPath << " is too long" << endl;
+		exit(0);
+	}
+
+	strcpy(address.sun_path, options.socketPath.c_str());
+
+	// Only a socket left behind by an earlier server is removed, never some other file at the path
+	struct stat existing;
+
+	if (lstat(options.socketPath.c_str(), &existing) == 0) {
+		if (!S_ISSOCK(existing.st_mode)) {
+			cout << options.socketPath << " already exists and isn't a socket" << endl;
+			exit(0);
+		}
+
+		unlink(options.socketPath.c_str());
+	}
+
+	// The session can load any file the server can read, so only the server's user may connect (the mask keeps the
+	// socket private between bind and chmod)
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	mode_t previousMask = umask(0177);
+	bool bound = listener >= 0 && ::bind(listener, (sockaddr*)&address, sizeof(address)) == 0;
+	umask(previousMask);
+
+	if (!bound || chmod(options.socketPath.c_str(), 0600) != 0 || listen(listener, 8) != 0) {
+		cout << "Cannot listen on " << options.socketPath << ": " << strerror(errno) << endl;
+		exit(0);
+	}
+
+	// A client that hangs up before its reply shouldn't take the server down
+	signal(SIGPIPE, SIG_IGN);
+
+	cout << "Serving on " << options.socketPath << endl;
+
+	bool stopping = false;
+	char buffer[65536];
+	const size_t maximumRequestLength = 1 << 20; // Clients sending longer lines are dropped
+
+	while (!stopping) {
+		int connection = accept(listener, NULL, NULL);
+
+		if (connection < 0) {
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		string received;
+		bool open = true;
+
+		// Sends one reply line, returns false if the client has gone
+		auto sendLine = [&](string reply) {
+			reply += "\n";
+
+			for (size_t sent = 0; sent < reply.size();) {
+				ssize_t bytesWritten = write(connection, reply.data() + sent, reply.size() - sent);
+
+				if (bytesWritten <= 0)
+					return false;
+
+				sent += bytesWritten;
+			}
+
+			return true;
+		};
+
+		while (open) {
+			ssize_t bytesRead = read(connection, buffer, sizeof(buffer));
+
+			if (bytesRead <= 0)
+				break;
+
+			received.append(buffer, bytesRead);
+
+			for (size_t lineEnd = received.find('\n'); lineEnd != string::npos && open; lineEnd = received.find('\n')) {
+				string request = received.substr(0, lineEnd);
+				received.erase(0, lineEnd + 1);
+
+				if (!request.empty() && request.back() == '\r')
+					request.pop_back();
+
+				string reply;
+
+				if (request == "quit") {
+					open = false;
+					continue;
+				}
+				else if (request == "shutdown") {
+					open = false;
+					stopping = true;
+					reply = "{\"ok\": true}";
+				}
+				else {
+					reply = session.handle(request);
+				}
+
+				if (!sendLine(reply))
+					open = false;
+			}
+
+			if (open && received.size() > maximumRequestLength) {
+				sendLine(PlanningSession::failure("request longer than " + to_string(maximumRequestLength) + " bytes"));
+				open = false;
+			}
+		}
+
+		close(connection);
+	}
+
+	close(listener);
+	unlink(options.socketPath.c_str());
+#endif
+}
+
+// Prints how the roadmap holds up when story points slip, if --risk asked for scenarios
+void reportRoadmapRisk(const PlannerOptions& options, Roadmap& roadmap, const vector<Sprint>& capacities) {
+	if (options.riskScenarios == 0)
+		return;
+
+	RiskEvaluator risk(roadmap, capacities, options.riskScenarios, options.estimateSpread, options.threads, options.seed);
+	risk.print(options.maximumOverflow);
+}
+
+int main(int argc, char* argv[]) {
+	PlannerOptions options;
+
+	if (!options.parse(argc, argv)) {
+		if (options.error != "")
+			cout << options.error << endl;
+
+		cout << "Usage: " << argv[0] << " <story data file> <sprint data file> [--solver=cplex|bnb|dp|lns|restarts|greedy|decompose|colgen] [--priority=input|density|critical-path|dependees] [--model=assignment|timeindexed] [--presolve=on|off] [--symmetry=on|off] [--dp=auto|off] [--time-limit=seconds] [--target-gap=fraction] [--seed=number] [--restarts=number] [--threads=number] [--mip-starts=number] [--iterations=number] [--horizon=sprints] [--profile=fast|balanced|prove-optimal] [--mip-gap=fraction] [--emphasis=balanced|feasibility|optimality|bestbound|hiddenfeas] [--work-mem=megabytes] [--tree-memory=megabytes] [--node-file=none|memory|disk|compressed-disk] [--config=file] [--cache-dir=directory] [--previous=roadmap file] [--freeze-sprints=number] [--write-roadmap=roadmap file] [--risk=scenarios] [--estimate-spread=sigma] [--max-overflow=fraction] [--capacity-buffer=fraction] [--telemetry=file] [--format=csv|json]" << endl;
+		cout << "       " << argv[0] << " <story data file> <sprint data file> --generate=<stories>x<sprints> [--seed=number] [--tightness=fraction] [--points-skew=ratio] [--value-skew=ratio] [--dependency-density=number] [--dependency-depth=number]" << endl;
+		cout << "       " << argv[0] << " [<story data file> <sprint data file>] --batch=manifest [--solver=name] [--threads=number] [--time-limit=seconds per scenario] [--cache-dir=directory] [--format=csv|json] [--output=file]" << endl;
+		cout << "       " << argv[0] << " [<story data file> <sprint data file>] --serve=socket [--solver=name] [--time-limit=seconds] [--threads=number] [--cache-dir=directory] [CPLEX options]" << endl;
+		cout << "       " << argv[0] << " --benchmark=suite [--sizes=<stories>x<sprints>,...] [--solvers=name,...] [--seeds=number] [--time-limit=seconds] [--format=csv|json] [--output=file] [generator options]" << endl;
+		cout << "       " << argv[0] << " --benchmark=tune [--sizes=<stories>x<sprints>,...] [--seeds=number] [--time-limit=seconds] [--target-gap=fraction] [--format=csv|json] [--output=file] [generator options]" << endl;
+		cout << "       " << argv[0] << " --benchmark=symmetry [--sizes=<stories>x<sprints>,...] [--solvers=bnb,cplex] [--seeds=number] [--time-limit=seconds] [--format=csv|json] [--output=file] [generator options]" << endl;
+		exit(0);
+	}
+
+	// Seeds the randomized parts of the solvers that don't take a seed of their own
+	mt19937 generator(options.seed);
+
+	if (options.benchmark == "suite") {
+		runBenchmarkSuite(options);
+		return 0;
+	}
+
+	if (options.benchmark == "tune") {
+		runProfileTuning(options);
+		return 0;
+	}
+
+	if (options.benchmark == "symmetry") {
+		runSymmetryBenchmark(options);
+		return 0;
+	}
+
+	if (options.batchFileName != "") {
+		runBatch(options);
+		return 0;
+	}
+
+	if (options.socketPath != "") {
+		runServer(options);
+		return 0;
+	}
+
+	if (options.generate != "") {
+		PlanningInstance instance = options.generator.generate(options.storiesToGenerate, options.sprintsToGenerate, options.seed);
+
+		if (!writeInstanceFiles(instance, options.storyDataFileName, options.sprintDataFileName)) {
+			cout << "Cannot write the data files" << endl;
+			exit(0);
+		}
+
+		cout << "Generated " << instance.numberOfStories() << " stories (" << instance.dependencies.size() << " dependencies) and "
+			<< instance.sprints.size() << " sprints with seed " << options.seed << endl;
+		return 0;
+	}
+
+	// Written out when main returns, after the phase timers below have finished
+	Telemetry telemetry(options.telemetryFileName, options.format);
+
+	string storyDataFileName;
+
+	// Holds the data about each sprint
+	vector<Sprint> sprintData;
+	string sprintDataFileName;
+
+	storyDataFileName = options.storyDataFileName;
+	sprintDataFileName = options.sprintDataFileName;
+
+	// Load story and sprint data /////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////
+
+	ScopedPhaseTimer loadTimer(telemetry, "load");
+
+	PlanningInstance instance;
+	string loadError;
+
+	bool loadedFromCache;
+
+	if (!loadPlanningInstance(storyDataFileName, sprintDataFileName, options.cacheDirectory, instance, loadError, loadedFromCache)) {
+		cout << loadError << endl;
+		exit(0);
+	}
+
+	sprintData = instance.toSprintData(); // Includes a special sprint representing 'unassigned' (i.e. assigned to the product backlog)
+
+	// Plan against reduced capacities, so sprints have room for stories that turn out bigger than estimated (the
+	// instance keeps the real ones, which the risk report measures overflows against)
+	for (Sprint& sprint : sprintData) {
+		if (sprint.sprintNumber != -1)
+			sprint.sprintCapacity = (int)floor(sprint.sprintCapacity * (1 - options.capacityBuffer));
+	}
+
+	// Roadmaps and solvers share the instance rather than copying it
+	shared_ptr<const PlanningInstance> sharedInstance = make_shared<const PlanningInstance>(move(instance));
+
+	loadTimer.stop();
+
+	if (options.benchmark == "loader") {
+		benchmarkLoaders(storyDataFileName, sprintDataFileName, options.cacheDirectory, 5);
+		return 0;
+	}
+
+	if (options.benchmark == "roadmap") {
+		benchmarkRoadmapMoves(sharedInstance, sprintData, 1000000);
+		return 0;
+	}
+
+	auto t_solveStart = chrono::high_resolution_clock::now();
+
+	int numberOfStories = sharedInstance->numberOfStories();
+	int numberOfSprints = sprintData.size();
+
+	telemetry.solver = options.solver == "cplex" ? "cplex-" + options.model : options.solver;
+	telemetry.numberOfStories = numberOfStories;
+	telemetry.numberOfSprints = numberOfSprints - 1;
+
+	// When re-planning, the previous roadmap is repaired for the current data and used to warm start the solver
+	bool replanning = options.previousRoadmapFileName != "";
+	Roadmap previousRoadmap;
+
+	if (replanning) {
+		vector<int> previousSprintNumbers;
+		string roadmapError;
+		int storiesKept;
+
+		ScopedPhaseTimer repairTimer(telemetry, "warm start");
+
+		if (!loadRoadmapFile(options.previousRoadmapFileName, numberOfStories, previousSprintNumbers, roadmapError)) {
+			cout << roadmapError << endl;
+			exit(0);
+		}
+
+		previousRoadmap = repairRoadmap(sharedInstance, sprintData, previousSprintNumbers, options.frozenSprints, storiesKept);
+		repairTimer.stop();
+
+		cout << "Re-planning from " << options.previousRoadmapFileName << ": " << storiesKept << " of " << numberOfStories
+			<< " stories kept their sprint, repaired roadmap value " << previousRoadmap.calculateValue() << endl << endl;
+	}
+
+	// Single-sprint instances, and chain instances with few enough sprints and story points, are knapsacks solved
+	// exactly by dynamic programming in place of the exact solvers
+	bool exactSolver = options.solver == "cplex" || options.solver == "bnb" || options.solver == "colgen";
+
+	if (options.solver == "dp" || (options.autoDynamicProgram && exactSolver && options.frozenSprints == 0 && options.horizon == 0)) {
+		KnapsackDynamicProgram program(*sharedInstance, sprintData);
+
+		if (program.applicable()) {
+			ScopedPhaseTimer searchTimer(telemetry, "search");
+			Roadmap roadmap = program.solve(Roadmap(sharedInstance, sprintData));
+			searchTimer.stop();
+
+			telemetry.solver = "dp";
+			telemetry.setResult("Optimal", roadmap.calculateValue());
+
+			auto t_solveEnd = chrono::high_resolution_clock::now();
+
+			printRoadmapSolution(roadmap, "Optimal", chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), roadmap.calculateValue());
+			cout << "Solved by dynamic programming over sprint capacity (" << program.chains.size() << " groups)" << endl;
+			reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+			saveRoadmap(options.roadmapOutputFileName, roadmap);
+			cout << "----------------------------------------" << endl;
+
+			return 0;
+		}
+
+		if (options.solver == "dp") {
+			// The table has a cell for every combination of sprint capacities, so chains over many sprints don't fit
+			cout << "The dynamic program needs a single sprint or chain dependencies (at most one dependency and one dependee per story), and at most "
+				<< KnapsackDynamicProgram::maximumBytes / (1 << 20) << " MB for a table with a cell for every combination of sprint capacities, so bnb is used instead" << endl << endl;
+			options.solver = "bnb";
+			telemetry.solver = "bnb";
+		}
+	}
+
+	if (options.horizon > 0) {
+		int numberOfWindows = max(1, numberOfSprints - 1 - options.horizon + 1);
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		RollingHorizonPlanner planner(sharedInstance, sprintData, options.horizon, options.solver, options.model, options.presolve,
+			options.timeLimit > 0 ? options.timeLimit / numberOfWindows : 0, options.cplexParameters, options.threads, options.seed);
+		planner.breakSymmetry = options.symmetryBreaking;
+		Roadmap roadmap = planner.solve();
+		searchTimer.stop();
+
+		telemetry.setResult("Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = certifiedUpperBound(*sharedInstance, sprintData, roadmap.calculateValue());
+		boundTimer.stop();
+
+		printRoadmapSolution(roadmap, "Feasible", chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		cout << "Rolling horizon: " << planner.windowsSolved << " windows of " << options.horizon << " sprints (and a lookahead) solved with "
+			<< options.solver << (planner.windowsOptimal ? ", each to optimality" : "") << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "bnb") {
+		ScopedPhaseTimer warmStartTimer(telemetry, "warm start");
+		BranchAndBoundSolver solver(sharedInstance, sprintData, options.timeLimit);
+		solver.breakSymmetry = options.symmetryBreaking;
+		Roadmap incumbent = greedyStartingRoadmap(sharedInstance, sprintData, generator);
+
+		if (replanning && previousRoadmap.calculateValue() > incumbent.calculateValue())
+			incumbent = previousRoadmap;
+
+		warmStartTimer.stop();
+		telemetry.addProgress(incumbent.calculateValue(), solver.upperBound(), NAN, 0);
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = solver.solve(incumbent);
+		searchTimer.stop();
+
+		telemetry.addProgress(roadmap.calculateValue(), solver.provedOptimal ? roadmap.calculateValue() : NAN, solver.provedOptimal ? 0 : NAN, solver.nodesExplored);
+		telemetry.setResult(solver.provedOptimal ? "Optimal" : "Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = solver.provedOptimal ? roadmap.calculateValue() : certifiedUpperBound(*sharedInstance, sprintData, roadmap.calculateValue());
+		boundTimer.stop();
+
+		printRoadmapSolution(roadmap, solver.provedOptimal ? "Optimal" : "Feasible (time limit reached)",
+			chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		cout << "Branch-and-bound nodes: " << solver.nodesExplored << endl;
+
+		if (options.symmetryBreaking)
+			cout << "Symmetry: " << SymmetryAnalysis(*sharedInstance, sprintData).describe() << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "greedy") {
+		// Re-planning with the greedy solver just gives the repaired roadmap
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = replanning ? previousRoadmap : greedyInsertStories(Roadmap(sharedInstance, sprintData), options.priorityRule);
+		searchTimer.stop();
+
+		telemetry.setResult("Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = certifiedUpperBound(*sharedInstance, sprintData, roadmap.calculateValue());
+		boundTimer.stop();
+
+		printRoadmapSolution(roadmap, "Feasible", chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "restarts") {
+		RestartPortfolio portfolio(sharedInstance, sprintData, options.restarts, options.threads, 1, options.timeLimit, options.seed);
+
+		// The bound is computed once, before the search, for both the target and the report
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		Roadmap greedy = greedyInsertStories(Roadmap(sharedInstance, sprintData), ValueDensity);
+		long long upperBound = certifiedUpperBound(*sharedInstance, sprintData, greedy.calculateValue());
+		portfolio.targetValue = targetRoadmapValue(upperBound, options.targetGap);
+		boundTimer.stop();
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = portfolio.run();
+		searchTimer.stop();
+
+		if (replanning && previousRoadmap.calculateValue() > roadmap.calculateValue())
+			roadmap = previousRoadmap;
+
+		telemetry.setResult("Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+		double milliseconds = chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count();
+
+		printRoadmapSolution(roadmap, "Feasible", milliseconds, upperBound);
+		cout << "Restarts: " << portfolio.restartsRun.load() << " on " << options.threads << " threads ("
+			<< (long long)(portfolio.restartsRun.load() / milliseconds * 1000) << " per second)" << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "lns") {
+		// The search has no natural end, so it always needs a time budget
+		double timeLimit = options.timeLimit > 0 ? options.timeLimit : 10;
+
+		ScopedPhaseTimer warmStartTimer(telemetry, "warm start");
+		LargeNeighbourhoodSearch search(sharedInstance, sprintData, timeLimit, options.seed);
+		Roadmap start = greedyStartingRoadmap(sharedInstance, sprintData, generator);
+
+		if (replanning && previousRoadmap.calculateValue() > start.calculateValue())
+			start = previousRoadmap;
+
+		warmStartTimer.stop();
+
+		// The bound is computed once, before the search, for both the target and the report
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = certifiedUpperBound(*sharedInstance, sprintData, start.calculateValue());
+		search.targetValue = targetRoadmapValue(upperBound, options.targetGap);
+		boundTimer.stop();
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = search.solve(start);
+		searchTimer.stop();
+
+		// The search reports its progress relative to its own start
+		for (pair<double, long long> improvement : search.progress)
+			telemetry.addProgress(improvement.second, NAN, NAN, 0, searchTimer.startMilliseconds + improvement.first);
+
+		telemetry.setResult("Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		printRoadmapSolution(roadmap, "Feasible", chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		cout << "Iterations: " << search.iterations << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "Best value over time:" << endl;
+
+		for (pair<double, long long> improvement : search.progress)
+			cout << "\t" << improvement.first << " ms: " << improvement.second << endl;
+
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "colgen") {
+		ScopedPhaseTimer warmStartTimer(telemetry, "warm start");
+		ColumnGenerationSolver columnGeneration(sprintData, options.cplexParameters, options.threads, options.timeLimit);
+		Roadmap start = greedyStartingRoadmap(sharedInstance, sprintData, generator);
+
+		if (replanning && previousRoadmap.calculateValue() > start.calculateValue())
+			start = previousRoadmap;
+
+		warmStartTimer.stop();
+		telemetry.addProgress(start.calculateValue(), NAN, NAN, 0);
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = columnGeneration.solve(start);
+		searchTimer.stop();
+
+		// The bound is infinite if the master LP was never solved
+		double bound = isfinite(columnGeneration.upperBound) ? columnGeneration.upperBound : NAN;
+		double gap = bound > 0 ? max(0.0, bound - roadmap.calculateValue()) / bound : NAN;
+		string status = columnGeneration.provedOptimal ? "Optimal" : "Feasible";
+
+		telemetry.addProgress(roadmap.calculateValue(), bound, gap, 0);
+		telemetry.setResult(status, roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = columnGeneration.provedOptimal ? roadmap.calculateValue()
+			: certifiedUpperBound(*sharedInstance, sprintData, roadmap.calculateValue(), columnGeneration.upperBound);
+		boundTimer.stop();
+
+		printRoadmapSolution(roadmap, status, chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		cout << "Column generation: " << columnGeneration.rounds << " pricing rounds, " << columnGeneration.columnsGenerated << " columns generated on "
+			<< options.threads << " threads" << (columnGeneration.converged ? ", LP relaxation solved" : "") << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	if (options.solver == "decompose") {
+		ScopedPhaseTimer warmStartTimer(telemetry, "warm start");
+		ComponentDecomposition decomposition(sharedInstance, sprintData, options.threads, options.iterations, options.timeLimit);
+		Roadmap start = greedyStartingRoadmap(sharedInstance, sprintData, generator);
+
+		if (replanning && previousRoadmap.calculateValue() > start.calculateValue())
+			start = previousRoadmap;
+
+		warmStartTimer.stop();
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		Roadmap roadmap = decomposition.solve(start);
+		searchTimer.stop();
+
+		double gap = decomposition.upperBound > 0 ? (decomposition.upperBound - roadmap.calculateValue()) / decomposition.upperBound : 0;
+
+		telemetry.addProgress(roadmap.calculateValue(), decomposition.upperBound, gap, 0);
+		telemetry.setResult("Feasible", roadmap.calculateValue());
+
+		auto t_solveEnd = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer boundTimer(telemetry, "bound");
+		long long upperBound = certifiedUpperBound(*sharedInstance, sprintData, roadmap.calculateValue(), decomposition.upperBound);
+		boundTimer.stop();
+
+		printRoadmapSolution(roadmap, "Feasible", chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count(), upperBound);
+		cout << "Components: " << decomposition.components.size() << " (largest has " << decomposition.largestComponent() << " stories)" << endl;
+		cout << "Lagrangian iterations: " << decomposition.iterations << " on " << options.threads << " threads" << endl;
+		reportRoadmapRisk(options, roadmap, sharedInstance->sprints);
+		saveRoadmap(options.roadmapOutputFileName, roadmap);
+		cout << "----------------------------------------" << endl;
+
+		return 0;
+	}
+
+	IloEnv env;
+
+	try {
+		IloModel model(env);
+
+		auto t_buildStart = chrono::high_resolution_clock::now();
+
+		ScopedPhaseTimer presolveTimer(telemetry, "presolve");
+		ModelPresolve presolve(*sharedInstance, sprintData, options.presolve);
+		presolveTimer.stop();
+
+		ScopedPhaseTimer buildTimer(telemetry, "model build");
+		IloArray<IloBoolVarArray> roadmap = createRoadmapVariables(env, numberOfSprints, numberOfStories);
+
+		if (options.model == "timeindexed")
+			buildTimeIndexedModel(env, model, roadmap, *sharedInstance, sprintData, presolve);
+		else
+			buildAssignmentModel(env, model, roadmap, *sharedInstance, sprintData, presolve);
+
+		// Committed stories are fixed in their sprints and nothing else can join a committed sprint, so CPLEX's
+		// presolve removes all of those variables (the count leaves out the ones our presolve kept out of the model)
+		int fixedVariables = 0;
+
+		if (options.frozenSprints > 0) {
+			for (int j = 0; j < numberOfStories; ++j) {
+				int committedPosition = previousRoadmap.storySprint[j];
+				int committedSprintNumber = sprintData[committedPosition].sprintNumber;
+				bool committed = committedSprintNumber != -1 && committedSprintNumber < options.frozenSprints;
+
+				for (int i = 0; i < numberOfSprints; ++i) {
+					bool frozenSprint = sprintData[i].sprintNumber != -1 && sprintData[i].sprintNumber < options.frozenSprints;
+
+					if (!presolve.reachable(i, j))
+						continue;
+
+					if (committed || frozenSprint) {
+						int value = committed && i == committedPosition ? 1 : 0;
+						roadmap[i][j].setBounds(value, value);
+						++fixedVariables;
+					}
+				}
+			}
+		}
+
+		// Committed sprints can't be put in any other order, so symmetry is only broken when nothing is frozen
+		bool breakSymmetry = options.symmetryBreaking && options.frozenSprints == 0;
+		SymmetryAnalysis symmetry(*sharedInstance, sprintData);
+		int symmetryRows = breakSymmetry ? addSymmetryBreaking(env, model, roadmap, *sharedInstance, sprintData, presolve, symmetry) : 0;
+
+		buildTimer.stop();
+
+		auto t_buildEnd = chrono::high_resolution_clock::now();
+
+		// Extract the model separately from creating the solver so extraction can be timed on its own
+		ScopedPhaseTimer extractTimer(telemetry, "extraction");
+		IloCplex cplex(env);
+		cplex.setOut(env.getNullStream());
+		cplex.extract(model);
+		extractTimer.stop();
+
+		auto t_extractEnd = chrono::high_resolution_clock::now();
+
+		if (options.telemetryFileName != "")
+			cplex.use(TelemetryCallback(env, &telemetry));
+
+		// CPLEX tuning
+		// http://www-01.ibm.com/support/docview.wss?uid=swg21400023#Item6
+		options.cplexParameters.apply(cplex, options.timeLimit, options.threads);
+
+		// Use MIP start to help the B&B by giving it a greedily-built solution
+		// https://www.ibm.com/support/knowledgecenter/SSSA5P_12.8.0/ilog.odms.cplex.help/CPLEX/OverviewAPIs/topics/MIP_starts.html
+
+		//////////////////////////////////////////////////////////////////////////
+
+		ScopedPhaseTimer warmStartTimer(telemetry, "warm start");
+
+		if (replanning) {
+			// The repaired previous roadmap is usually close to the new optimum
+			addRoadmapMIPStart(env, cplex, roadmap, sprintData, previousRoadmap.storySprint, sharedInstance.get(), breakSymmetry ? &symmetry : NULL);
+		}
+
+		if (options.restarts > 0) {
+			// Give CPLEX the best few roadmaps from a parallel portfolio of randomized greedy restarts
+			RestartPortfolio portfolio(sharedInstance, sprintData, options.restarts, options.threads, options.mipStarts, 0, options.seed);
+			portfolio.run();
+
+			for (pair<long long, vector<int>>& solution : portfolio.bestSolutions)
+				addRoadmapMIPStart(env, cplex, roadmap, sprintData, solution.second, sharedInstance.get(), breakSymmetry ? &symmetry : NULL);
+		}
+		else if (!replanning) {
+			Roadmap warmStart = randomRoadmap(sharedInstance, sprintData, generator);
+			addRoadmapMIPStart(env, cplex, roadmap, sprintData, warmStart.storySprint, sharedInstance.get(), breakSymmetry ? &symmetry : NULL);
+		}
+
+		warmStartTimer.stop();
+
+		//////////////////////////////////////////////////////////////////////////
+
+		ScopedPhaseTimer searchTimer(telemetry, "search");
+		bool solved = cplex.solve();
+		searchTimer.stop();
+
+		if (solved) {
+			auto t_solveEnd = chrono::high_resolution_clock::now();
+
+			ostringstream status;
+			status << cplex.getStatus();
+			telemetry.setResult(status.str(), cplex.getObjValue());
+
+			ScopedPhaseTimer outputTimer(telemetry, "output");
+
+			// One getValues call per sprint, then the stories are grouped by sprint in story number order
+			vector<int> storySprint = extractRoadmap(env, cplex, roadmap, sprintData, numberOfStories, presolve);
+			Roadmap solution(sharedInstance, sprintData);
+
+			for (int j = 0; j < numberOfStories; ++j) {
+				if (storySprint[j] != -1)
+					solution.addStoryToSprint(j, sprintData[storySprint[j]]);
+			}
+
+			// Output the solution
+			{
+				BufferedWriter output(cout);
+
+				for (int i = 0; i < numberOfSprints; ++i) {
+					// Sprint information
+					sprintData[i].write(output);
+					output << '\n';
+
+					long long businessValueDelivered = 0;
+					long long storyPointsDelivered = 0;
+
+					for (int j : solution.sprintStories[i]) {
+						businessValueDelivered += sharedInstance->businessValue[j];
+						storyPointsDelivered += sharedInstance->storyPoints[j];
+
+						output << '\t';
+						sharedInstance->writeStory(output, j);
+						output << '\n';
+					}
+
+					// What was delivered in the sprint
+					output << "-- [Value: " << businessValueDelivered << " (weighted business value: " << businessValueDelivered * sprintData[i].sprintBonus << "), "
+						<< "story points: " << storyPointsDelivered << "]\n\n";
+				}
+			}
+
+			cout << endl << cplex.getStatus() << endl;
+			cout << "Solved in " << chrono::duration<double, std::milli>(t_solveEnd - t_solveStart).count() << " ms" << endl << endl;
+			cout << "Profile: " << options.cplexParameters.profile << endl;
+			cout << "Model: " << options.model << " (" << cplex.getNcols() << " columns, " << cplex.getNrows() << " rows, " << cplex.getNNZs() << " non-zeros)" << endl;
+			cout << "Model built in " << chrono::duration<double, std::milli>(t_buildEnd - t_buildStart).count() << " ms, "
+				<< "extracted in " << chrono::duration<double, std::milli>(t_extractEnd - t_buildEnd).count() << " ms, "
+				<< "searched in " << chrono::duration<double, std::milli>(t_solveEnd - t_extractEnd).count() << " ms" << endl;
+			cout << "Presolve: " << presolve.eliminatedVariables() << " variables and " << presolve.eliminatedConstraints << " constraints eliminated, "
+				<< presolve.impossibleStories << " stories can never be delivered" << endl;
+			cout << "Stories: " << sharedInstance->numberOfStories() << ", sprints: " << sprintData.size() << endl;
+
+			if (options.frozenSprints > 0)
+				cout << "Frozen sprints: " << options.frozenSprints << " (" << fixedVariables << " variables fixed)" << endl;
+
+			if (breakSymmetry)
+				cout << "Symmetry: " << symmetry.describe() << ", " << symmetryRows << " rows added, " << cplex.getNnodes() << " nodes explored" << endl;
+
+			cout << "Total weighted business value: " << cplex.getObjValue() << endl << endl;
+			reportRoadmapRisk(options, solution, sharedInstance->sprints);
+			saveRoadmap(options.roadmapOutputFileName, solution);
+			cout << "----------------------------------------" << endl;
 		}
 		else {
+			telemetry.setResult("No solution", NAN);
 			cout << " No solution found" << endl;
 		}
 